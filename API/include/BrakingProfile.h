@@ -0,0 +1,86 @@
+/*
+ * BrakingProfile.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace ev3 {
+
+/**
+ * Кривая торможения: скорость, с которой можно ехать, если до цели осталось remaining градусов
+ * энкодера и робот тормозит с постоянным замедлением: v = sqrt(2 * a * remaining).
+ * Робот едет с максимальной мощностью, пока кривая не опустится ниже неё, поэтому торможение
+ * начинается в самой поздней возможной точке, а остановка занимает минимальное время.
+ *
+ * Замедление измеряется на роботе: при сбросе мощности со скорости v робот проезжает d градусов,
+ * тогда a = v^2 / (2 * d) (см. measureDeceleration).
+ */
+class BrakingProfile {
+public:
+	/**
+	 * @param deceleration замедление в градусах энкодера за секунду в квадрате
+	 * @param speedOnMaxPower скорость на мощности 100 в градусах за секунду (см. Motor::getSpeedOnMaxPower)
+	 * @param startUpPower мощность, необходимая для начала движения (см. Motor::getStartUpPower)
+	 * @param minPower мощность, с которой робот доезжает последние градусы
+	 */
+	explicit BrakingProfile(float deceleration = 3000.0f, float speedOnMaxPower = 850.0f, int startUpPower = 3, int minPower = 7)
+	: deceleration(deceleration), speedOnMaxPower(speedOnMaxPower), startUpPower(startUpPower), minPower(minPower) {
+	}
+
+	/**
+	 * Допустимая скорость в градусах за секунду
+	 * @param remaining оставшееся расстояние в градусах энкодера
+	 */
+	float getVelocity(float remaining) const {
+		return remaining <= 0 ? 0.0f : std::sqrt(2 * deceleration * remaining);
+	}
+
+	/**
+	 * Мощность, соответствующая допустимой скорости
+	 * @param remaining оставшееся расстояние в градусах энкодера
+	 * @param maxPower максимальная мощность
+	 */
+	int getPower(float remaining, int maxPower) const {
+		if (remaining <= 0) {
+			return 0;
+		}
+		int power = startUpPower + (int)(getVelocity(remaining) * 100 / speedOnMaxPower);
+		return std::max(std::min(power, maxPower), std::min(minPower, maxPower));
+	}
+
+	/**
+	 * Тормозной путь со скорости velocity
+	 * @param velocity скорость в градусах за секунду
+	 * @return расстояние в градусах энкодера
+	 */
+	float getBrakingDistance(float velocity) const {
+		return velocity * velocity / (2 * deceleration);
+	}
+
+	/**
+	 * Замедление по результатам измерения
+	 * @param velocity скорость в момент сброса мощности, градусов за секунду
+	 * @param distance путь до остановки в градусах энкодера
+	 */
+	static float measureDeceleration(float velocity, float distance) {
+		return distance <= 0 ? 0.0f : velocity * velocity / (2 * distance);
+	}
+
+	float getDeceleration() const { return deceleration; }
+
+	void setDeceleration(float deceleration) { this->deceleration = deceleration; }
+
+private:
+	float deceleration;
+	float speedOnMaxPower;
+	int startUpPower;
+	int minPower;
+};
+
+} /* namespace ev3 */
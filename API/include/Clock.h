@@ -0,0 +1,104 @@
+/*
+ * Clock.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "common.h"
+
+namespace ev3 {
+
+/**
+ * Время текущего такта в целых микросекундах.
+ * Собственных часов у класса нет: время читается один раз в начале такта из часов EV3
+ * (см. EV3::readTicks) и кэшируется, поэтому процессы, устройства и провода работают в одной
+ * шкале времени и в пределах такта видят одно и то же значение.
+ */
+class Clock {
+public:
+	/**
+	 * Начало нового такта. Вызывается циклом EV3::runProcess перед updateInputs.
+	 * @param ticks время в микросекундах, прочитанное из EV3::timestamp
+	 */
+	static void beginTick(ticks_t ticks) {
+		currentTick = ticks;
+		currentSeconds = ticksToSeconds(currentTick);
+		currentEpoch++;
+	}
+
+	/**
+	 * Номер текущего такта. Используется для кэширования значений, которые
+	 * достаточно вычислять не чаще одного раза за такт (см. CachedWire).
+	 * Номер меняется только в цикле EV3::runProcess, поэтому кэш по номеру такта
+	 * допустим только при isTicking
+	 * @return номер такта
+	 */
+	static uint32_t epoch() {
+		return currentEpoch;
+	}
+
+	/**
+	 * Выполняется цикл EV3::runProcess. Вне его (EV3::wait, EV3::runLoop) входные данные
+	 * обновляются библиотекой без начала нового такта, и значения, закэшированные по номеру такта, устаревают
+	 * @return true, если такты идут
+	 */
+	static bool isTicking() {
+		return loopDepth > 0;
+	}
+
+	/**
+	 * Начало и конец цикла EV3::runProcess (см. Loop)
+	 */
+	static void enterLoop() {
+		loopDepth++;
+	}
+
+	static void leaveLoop() {
+		loopDepth--;
+	}
+
+	/**
+	 * Цикл EV3::runProcess на время жизни объекта: leaveLoop вызывается и тогда,
+	 * когда процесс завершается исключением
+	 */
+	class Loop {
+	public:
+		Loop() {
+			enterLoop();
+		}
+
+		~Loop() {
+			leaveLoop();
+		}
+
+		Loop(const Loop&) = delete;
+		Loop& operator=(const Loop&) = delete;
+	};
+
+	/**
+	 * Время текущего такта
+	 * @return время в микросекундах
+	 */
+	static ticks_t tick() {
+		return currentTick;
+	}
+
+	/**
+	 * Время текущего такта для старого интерфейса, принимающего секунды
+	 * @return время в секундах
+	 */
+	static time_t tickSeconds() {
+		return currentSeconds;
+	}
+
+private:
+	static inline ticks_t currentTick = 0;
+	static inline time_t currentSeconds = 0;
+	static inline uint32_t currentEpoch = 0;
+	static inline int loopDepth = 0;
+};
+
+} /* namespace ev3 */
@@ -0,0 +1,157 @@
+/*
+ * ColorLookupTable.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Sensor.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace ev3 {
+
+/**
+ * Преобразование цвета из модели RGB в HSV только в целых числах.
+ * Диапазоны те же, что у rgbToHsv: H - [0, 360), S и V - [0, 100].
+ * @param rgb цвет
+ * @return цвет в модели HSV
+ */
+inline HSV rgbToHsvInt(const RGB &rgb) {
+	const int r = rgb.r;
+	const int g = rgb.g;
+	const int b = rgb.b;
+	const int max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+	const int min = r < g ? (r < b ? r : b) : (g < b ? g : b);
+	const int delta = max - min;
+
+	const int v = (max * 100 + 127) / 255;
+	const int s = max == 0 ? 0 : (delta * 100 + max / 2) / max;
+	int h = 0;
+	if (delta != 0) {
+		if (max == r) {
+			h = 60 * (g - b) / delta;
+		} else if (max == g) {
+			h = 120 + 60 * (b - r) / delta;
+		} else {
+			h = 240 + 60 * (r - g) / delta;
+		}
+		if (h < 0) {
+			h += 360;
+		}
+	}
+	return HSV((short)h, (unsigned char)s, (unsigned char)v);
+}
+
+/**
+ * Классификация цвета по таблице. Таблица строится один раз для набора цветов и порогов
+ * по квантованному RGB (BITS старших бит каждой компоненты): для центра каждой ячейки выполняется
+ * преобразование в HSV и поиск ближайшего по тону цвета. После этого классификация значения -
+ * одно чтение из таблицы без преобразования и поиска.
+ *
+ * Таблица строится по откалиброванному RGB (ColorSensor::getRGBColor), поэтому после изменения
+ * калибровки датчика её перестраивать не нужно; перестраивать нужно при изменении набора цветов или порогов.
+ *
+ * Правила соответствуют описанию ColorSensor::getColorIndex:
+ * - NO_COLOR, если датчик ничего не видит (все компоненты равны 0; проверяется до чтения таблицы,
+ *   остальные значения нижней ячейки классифицируются по её центру, как в любой другой ячейке);
+ * - BLACK_COLOR, если V < blackVThreshold;
+ * - WHITE_COLOR, если S < whiteSThreshold и V > whiteVThreshold;
+ * - иначе индекс цвета с ближайшим тоном.
+ *
+ * @tparam BITS количество бит на компоненту, таблица занимает 2^(3 * BITS) байт
+ */
+template<int BITS = 5>
+class ColorLookupTable {
+	static_assert(BITS >= 1 && BITS <= 6, "ColorLookupTable supports 1..6 bits per component");
+
+public:
+	static const int LEVELS = 1 << BITS;
+	static const int SIZE = LEVELS * LEVELS * LEVELS;
+
+	ColorLookupTable() = default;
+
+	ColorLookupTable(const std::vector<int> &colors, int blackVThreshold = 10, int whiteSThreshold = 20, int whiteVThreshold = 60) {
+		build(colors, blackVThreshold, whiteSThreshold, whiteVThreshold);
+	}
+
+	/**
+	 * Построение таблицы
+	 * @param colors значения Hue цветов
+	 * @param blackVThreshold порог V для чёрного цвета
+	 * @param whiteSThreshold порог S для белого цвета
+	 * @param whiteVThreshold порог V для белого цвета
+	 */
+	void build(const std::vector<int> &colors, int blackVThreshold = 10, int whiteSThreshold = 20, int whiteVThreshold = 60) {
+		table.resize(SIZE);
+		const int shift = 8 - BITS;
+		const int center = (1 << shift) >> 1;
+		for (int r = 0; r < LEVELS; ++r) {
+			for (int g = 0; g < LEVELS; ++g) {
+				for (int b = 0; b < LEVELS; ++b) {
+					const RGB rgb((unsigned char)((r << shift) + center), (unsigned char)((g << shift) + center), (unsigned char)((b << shift) + center));
+					table[index(r, g, b)] = (int8_t)classify(rgb, colors, blackVThreshold, whiteSThreshold, whiteVThreshold);
+				}
+			}
+		}
+	}
+
+	bool isBuilt() const {
+		return !table.empty();
+	}
+
+	/**
+	 * Цвет по таблице
+	 * @param rgb откалиброванный цвет
+	 * @return индекс в массиве цветов или BLACK_COLOR, WHITE_COLOR, NO_COLOR
+	 */
+	int getColorIndex(const RGB &rgb) const {
+		if (rgb.r == 0 && rgb.g == 0 && rgb.b == 0) {
+			return NO_COLOR;
+		}
+		const int shift = 8 - BITS;
+		return table[index(rgb.r >> shift, rgb.g >> shift, rgb.b >> shift)];
+	}
+
+	/**
+	 * Классификация без таблицы (используется при построении)
+	 */
+	static int classify(const RGB &rgb, const std::vector<int> &colors, int blackVThreshold, int whiteSThreshold, int whiteVThreshold) {
+		if (rgb.r == 0 && rgb.g == 0 && rgb.b == 0) {
+			return NO_COLOR;
+		}
+		const HSV hsv = rgbToHsvInt(rgb);
+		if (hsv.v < blackVThreshold) {
+			return BLACK_COLOR;
+		}
+		if (hsv.s < whiteSThreshold && hsv.v > whiteVThreshold) {
+			return WHITE_COLOR;
+		}
+		int best = NO_COLOR;
+		int bestDistance = 360;
+		for (size_t i = 0; i < colors.size(); ++i) {
+			int distance = std::abs(hsv.h - colors[i]) % 360;
+			if (distance > 180) {
+				distance = 360 - distance;
+			}
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				best = (int)i;
+			}
+		}
+		return best;
+	}
+
+private:
+	static int index(int r, int g, int b) {
+		return (r << (2 * BITS)) | (g << BITS) | b;
+	}
+
+	std::vector<int8_t> table;
+};
+
+} /* namespace ev3 */
@@ -0,0 +1,157 @@
+/*
+ * CrossDetector.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Ring.h"
+
+#include <cstdlib>
+
+namespace ev3 {
+
+/**
+ * Поиск перекрёстка по двум датчикам линии.
+ * Значения датчиков записываются не на каждом такте, а через каждые sampleStep градусов энкодера,
+ * поэтому окно всегда покрывает одно и то же расстояние, а результат не зависит ни от частоты цикла,
+ * ни от скорости робота. Если за такт робот проехал несколько шагов, промежуточные значения
+ * интерполируются. Среднее в окне поддерживается скользящей суммой и обновляется за O(1).
+ *
+ * Перекрёсток найден, когда среднее в окне опустилось ниже порога на обоих датчиках, причём
+ * не дальше maxSkew градусов друг от друга. Датчики могут пересечь линию в разные моменты (робот подъехал
+ * под углом), поэтому для каждой стороны запоминается расстояние, на котором она последний раз была на чёрном.
+ * Расстояние отсчитывается от reset по энкодеру своей стороны. При колебаниях во время движения по линии
+ * датчики заходят на линию по очереди, но дальше друг от друга, чем maxSkew, и перекрёсток не находится.
+ */
+template<int WINDOW = 20>
+class CrossDetector {
+public:
+	/**
+	 * @param meanThreshold пороговое среднее значение яркости в окне
+	 * @param sampleStep расстояние между записываемыми значениями в градусах энкодера
+	 * @param maxSkew наибольшее расстояние между срабатываниями сторон в градусах энкодера
+	 */
+	explicit CrossDetector(int meanThreshold = 50, int sampleStep = 1, int maxSkew = WINDOW)
+	: meanThreshold(meanThreshold), sampleStep(sampleStep < 1 ? 1 : sampleStep), maxSkew(maxSkew) {
+	}
+
+	/**
+	 * Сброс накопленных значений
+	 * @param leftEncoder текущее значение левого энкодера
+	 * @param rightEncoder текущее значение правого энкодера
+	 */
+	void reset(int leftEncoder, int rightEncoder) {
+		left.reset(leftEncoder);
+		right.reset(rightEncoder);
+	}
+
+	/**
+	 * Обработка нового такта с новыми значениями обоих датчиков
+	 * @return true, если найден перекрёсток
+	 */
+	bool update(int leftEncoder, int leftValue, int rightEncoder, int rightValue) {
+		updateLeft(leftEncoder, leftValue);
+		updateRight(rightEncoder, rightValue);
+		return isDetected();
+	}
+
+	/**
+	 * Новое значение левого датчика. Если новое значение есть только у одного датчика, обновляется
+	 * только его сторона: повтор старого значения другого датчика исказил бы интерполяцию
+	 */
+	void updateLeft(int leftEncoder, int leftValue) {
+		left.update(leftEncoder, leftValue, sampleStep, meanThreshold);
+	}
+
+	/**
+	 * Новое значение правого датчика (см. updateLeft)
+	 */
+	void updateRight(int rightEncoder, int rightValue) {
+		right.update(rightEncoder, rightValue, sampleStep, meanThreshold);
+	}
+
+	/**
+	 * Перекрёсток найден: обе стороны были на чёрном не дальше maxSkew градусов друг от друга
+	 */
+	bool isDetected() const {
+		return left.detected && right.detected && std::abs(left.detectedDistance - right.detectedDistance) <= maxSkew;
+	}
+
+	void setMeanThreshold(int meanThreshold) {
+		this->meanThreshold = meanThreshold;
+	}
+
+	void setMaxSkew(int maxSkew) {
+		this->maxSkew = maxSkew;
+	}
+
+	void setSampleStep(int sampleStep) {
+		this->sampleStep = sampleStep < 1 ? 1 : sampleStep;
+	}
+
+	/**
+	 * Среднее значение в окне левого датчика
+	 */
+	float getLeftMean() const { return left.window.getMean(); }
+
+	/**
+	 * Среднее значение в окне правого датчика
+	 */
+	float getRightMean() const { return right.window.getMean(); }
+
+	static const int windowWidth = WINDOW;
+
+private:
+	struct Side {
+		StatisticsRing<int, WINDOW> window;
+		int sampledEncoder = 0;
+		int sampledValue = 0;
+		bool hasValue = false;
+		int startEncoder = 0;
+		// сторона была на чёрном, последний раз - на расстоянии detectedDistance от начала
+		bool detected = false;
+		int detectedDistance = 0;
+
+		void reset(int encoder) {
+			window.clear();
+			sampledEncoder = encoder;
+			startEncoder = encoder;
+			hasValue = false;
+			detected = false;
+		}
+
+		void update(int encoder, int value, int step, int threshold) {
+			if (!hasValue) {
+				sampledValue = value;
+				hasValue = true;
+			}
+			const int distance = encoder - sampledEncoder;
+			const int steps = std::abs(distance) / step;
+			if (steps > 0) {
+				// проехали больше окна - промежуточные значения всё равно будут вытеснены
+				const int first = steps > WINDOW ? steps - WINDOW + 1 : 1;
+				for (int i = first; i <= steps; ++i) {
+					window.push(sampledValue + (value - sampledValue) * i / steps);
+				}
+				sampledEncoder += (distance > 0 ? steps : -steps) * step;
+				sampledValue = value;
+			}
+
+			if (window.size() == WINDOW && window.getMean() < threshold) {
+				detected = true;
+				detectedDistance = std::abs(encoder - startEncoder);
+			}
+		}
+	};
+
+	int meanThreshold;
+	int sampleStep;
+	int maxSkew;
+	Side left;
+	Side right;
+};
+
+} /* namespace ev3 */
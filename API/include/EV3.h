@@ -8,6 +8,7 @@
 #pragma once
 
 #include "common.h"
+#include "Clock.h"
 
 #include "Sensor.h"
 #include "Motor.h"
@@ -131,6 +132,26 @@ enum class LEDPattern : uint8_t {
 		 * @return время в секундах
 		 */
 		time_t timestamp();
+
+		/**
+		 * Чтение часов блока в микросекундах. Те же часы, что и timestamp (отсчёт от zeroTimestamp),
+		 * но без перевода в секунды: значение float теряет микросекунды уже через несколько минут работы.
+		 * Значения можно сравнивать с временем такта (см. ticks)
+		 * @return время в микросекундах
+		 */
+		inline ticks_t readTicks() {
+			return std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::high_resolution_clock::now() - zeroTimestamp).count();
+		}
+
+		/**
+		 * Время текущего такта. В отличие от timestamp, часы не читаются повторно,
+		 * возвращается значение, закэшированное в начале такта
+		 * @return время в микросекундах
+		 */
+		inline ticks_t ticks() const {
+			return Clock::tick();
+		}
 		/**
 		 * Ожидание в течение определённого времени. При этом происходит обновление входных и выходных данных
 		 * @param seconds время в секундах
@@ -191,9 +212,10 @@ enum class LEDPattern : uint8_t {
 		template<class ProcessClass>
 		void runProcess(ProcessClass *process) {
 			static_assert(std::is_base_of<Process, ProcessClass>::value);
-			time_t timestamp = this->timestamp();;
+			Clock::Loop loop;
+			time_t timestamp = beginTick();
 			while (!process->isCompleted(timestamp)) {
-				timestamp = this->timestamp();
+				timestamp = beginTick();
 				updateInputs(timestamp);
 				process->update(timestamp);
 				updateOutputs(timestamp);
@@ -211,9 +233,10 @@ enum class LEDPattern : uint8_t {
 		template<class ProcessClass>
 		void runProcess(std::shared_ptr<ProcessClass> process) {
 			static_assert(std::is_base_of<Process, ProcessClass>::value);
-			time_t timestamp = this->timestamp();;
+			Clock::Loop loop;
+			time_t timestamp = beginTick();
 			while (!process->isCompleted(timestamp)) {
-				timestamp = this->timestamp();
+				timestamp = beginTick();
 				updateInputs(timestamp);
 				process->update(timestamp);
 				updateOutputs(timestamp);
@@ -231,9 +254,10 @@ enum class LEDPattern : uint8_t {
 		template<class ProcessClass>
 		void runProcess(ProcessClass &process) {
 			static_assert(std::is_base_of<Process, ProcessClass>::value);
-			time_t timestamp = this->timestamp();;
+			Clock::Loop loop;
+			time_t timestamp = beginTick();
 			while (!process.isCompleted(timestamp)) {
-				timestamp = this->timestamp();
+				timestamp = beginTick();
 				updateInputs(timestamp);
 				process.update(timestamp);
 				updateOutputs(timestamp);
@@ -251,9 +275,10 @@ enum class LEDPattern : uint8_t {
 		template<class ProcessClass>
 		void runProcess(ProcessClass &&process) {
 			static_assert(std::is_base_of<Process, ProcessClass>::value);
-			time_t timestamp = this->timestamp();;
+			Clock::Loop loop;
+			time_t timestamp = beginTick();
 			while (!process.isCompleted(timestamp)) {
-				timestamp = this->timestamp();
+				timestamp = beginTick();
 				updateInputs(timestamp);
 				process.update(timestamp);
 				updateOutputs(timestamp);
@@ -341,6 +366,16 @@ enum class LEDPattern : uint8_t {
 		void setupLogger(const std::string &filename);
 
 	private:
+		/**
+		 * Начало такта: однократное чтение часов в целых микросекундах. Секунды для процессов
+		 * со старым интерфейсом вычисляются из них один раз (см. Clock::tickSeconds)
+		 * @return время такта в секундах для процессов со старым интерфейсом
+		 */
+		inline time_t beginTick() {
+			Clock::beginTick(readTicks());
+			return Clock::tickSeconds();
+		}
+
 		std::map<Sensor::Port, std::shared_ptr<Sensor>> sensors;
 		std::map<Motor::Port, std::shared_ptr<Motor>> motors;
 		std::unique_ptr<Logger> logger;
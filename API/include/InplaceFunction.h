@@ -0,0 +1,143 @@
+/*
+ * InplaceFunction.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ev3 {
+
+/**
+ * Размер встроенного буфера InplaceFunction по умолчанию: до шести захваченных ссылок или указателей.
+ */
+const size_t INPLACE_FUNCTION_CAPACITY = 6 * sizeof(void*);
+
+template<typename Signature, size_t Capacity = INPLACE_FUNCTION_CAPACITY>
+class InplaceFunction;
+
+/**
+ * Аналог std::function, который никогда не выделяет память в куче: функция (лямбда) хранится
+ * во встроенном буфере фиксированного размера. Если захваченные значения не помещаются в буфер,
+ * возникает ошибка компиляции - в таком случае следует захватывать ссылки или умные указатели.
+ */
+template<typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+	InplaceFunction() noexcept = default;
+
+	InplaceFunction(std::nullptr_t) noexcept {
+	}
+
+	template<class F, typename = std::enable_if_t<
+			!std::is_same<std::decay_t<F>, InplaceFunction>::value
+			&& std::is_invocable_r<R, std::decay_t<F> &, Args...>::value>>
+	InplaceFunction(F &&function) {
+		using Function = std::decay_t<F>;
+		static_assert(sizeof(Function) <= Capacity, "InplaceFunction: captured state does not fit into the inplace buffer");
+		static_assert(alignof(Function) <= alignof(std::max_align_t), "InplaceFunction: captured state is over-aligned");
+		new (storage) Function(std::forward<F>(function));
+		operations = &OperationsFor<Function>::table;
+	}
+
+	InplaceFunction(const InplaceFunction &other) {
+		if (other.operations) {
+			other.operations->copy(storage, other.storage);
+			operations = other.operations;
+		}
+	}
+
+	InplaceFunction(InplaceFunction &&other) noexcept {
+		if (other.operations) {
+			other.operations->move(storage, other.storage);
+			operations = other.operations;
+		}
+	}
+
+	~InplaceFunction() {
+		clear();
+	}
+
+	InplaceFunction& operator=(const InplaceFunction &other) {
+		if (this != &other) {
+			clear();
+			if (other.operations) {
+				other.operations->copy(storage, other.storage);
+				operations = other.operations;
+			}
+		}
+		return *this;
+	}
+
+	InplaceFunction& operator=(InplaceFunction &&other) noexcept {
+		if (this != &other) {
+			clear();
+			if (other.operations) {
+				other.operations->move(storage, other.storage);
+				operations = other.operations;
+			}
+		}
+		return *this;
+	}
+
+	InplaceFunction& operator=(std::nullptr_t) noexcept {
+		clear();
+		return *this;
+	}
+
+	/**
+	 * Вызов функции. Вызывать пустую функцию нельзя.
+	 */
+	inline R operator()(Args... args) const {
+		return operations->invoke(storage, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const noexcept {
+		return operations != nullptr;
+	}
+
+	static const size_t capacity = Capacity;
+
+private:
+	struct Operations {
+		R (*invoke)(void *storage, Args&&... args);
+		void (*copy)(void *destination, const void *source);
+		void (*move)(void *destination, void *source);
+		void (*destroy)(void *storage);
+	};
+
+	template<class Function>
+	struct OperationsFor {
+		static R invoke(void *storage, Args&&... args) {
+			return (*static_cast<Function*>(storage))(std::forward<Args>(args)...);
+		}
+		static void copy(void *destination, const void *source) {
+			new (destination) Function(*static_cast<const Function*>(source));
+		}
+		static void move(void *destination, void *source) {
+			new (destination) Function(std::move(*static_cast<Function*>(source)));
+		}
+		static void destroy(void *storage) {
+			static_cast<Function*>(storage)->~Function();
+		}
+		static constexpr Operations table = { &invoke, &copy, &move, &destroy };
+	};
+
+	void clear() {
+		if (operations) {
+			operations->destroy(storage);
+			operations = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) mutable unsigned char storage[Capacity];
+	const Operations *operations = nullptr;
+};
+
+} /* namespace ev3 */
@@ -0,0 +1,205 @@
+/*
+ * MotionProfile.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include <cmath>
+
+namespace ev3 {
+
+/**
+ * Профиль движения на заданное расстояние с ограничениями скорости, ускорения и рывка.
+ * Без ограничения рывка профиль трапециевидный: разгон с максимальным ускорением, движение
+ * с максимальной скоростью, торможение. Если расстояние мало, максимальная скорость не достигается
+ * и профиль становится треугольным.
+ *
+ * С ограничением рывка (S-кривая) трапециевидный профиль усредняется скользящим окном длительностью
+ * maxAcceleration / maxJerk: ускорение нарастает линейно, скорость и ускорение не превышают ограничений,
+ * пройденное расстояние не меняется, а время движения увеличивается на длительность окна.
+ *
+ * Профиль не хранит состояния, getState можно вызывать для любого момента времени.
+ */
+class MotionProfile {
+public:
+	/**
+	 * Ограничения движения. Единицы - градусы энкодера и секунды.
+	 */
+	struct Limits {
+		float maxVelocity;
+		float maxAcceleration;
+		float maxJerk; //!< 0 - рывок не ограничен, трапециевидный профиль
+	};
+
+	/**
+	 * Положение, скорость и ускорение в некоторый момент времени
+	 */
+	struct State {
+		float position;
+		float velocity;
+		float acceleration;
+	};
+
+	MotionProfile()
+	: MotionProfile(0, { 1, 1, 0 }) {
+	}
+
+	/**
+	 * @param distance расстояние, может быть отрицательным
+	 * @param limits ограничения
+	 */
+	MotionProfile(float distance, const Limits &limits)
+	: direction(distance < 0 ? -1.0f : 1.0f), distance(std::fabs(distance)), acceleration(limits.maxAcceleration) {
+		// трапеция: если разгон до maxVelocity и торможение не помещаются в расстояние - треугольник
+		const float fullAccelerationDistance = limits.maxVelocity * limits.maxVelocity / limits.maxAcceleration;
+		if (this->distance >= fullAccelerationDistance) {
+			peakVelocity = limits.maxVelocity;
+			accelerationTime = peakVelocity / acceleration;
+			cruiseTime = (this->distance - fullAccelerationDistance) / peakVelocity;
+		} else {
+			peakVelocity = std::sqrt(this->distance * acceleration);
+			accelerationTime = peakVelocity / acceleration;
+			cruiseTime = 0;
+		}
+		jerkTime = limits.maxJerk > 0 ? acceleration / limits.maxJerk : 0;
+		if (cruiseTime < jerkTime) {
+			// окно не должно одновременно захватывать разгон и торможение, иначе рывок удваивается:
+			// снижаем пиковую скорость так, чтобы участок постоянной скорости был не короче окна
+			// distance = v^2 / a + v * jerkTime
+			peakVelocity = (std::sqrt(jerkTime * jerkTime + 4 * this->distance / acceleration) - jerkTime) * acceleration / 2;
+			accelerationTime = peakVelocity / acceleration;
+			cruiseTime = jerkTime;
+		}
+		trapezoidTime = 2 * accelerationTime + cruiseTime;
+
+		accelerationPosition = acceleration * accelerationTime * accelerationTime / 2;
+		cruisePosition = accelerationPosition + peakVelocity * cruiseTime;
+		accelerationIntegral = acceleration * accelerationTime * accelerationTime * accelerationTime / 6;
+		cruiseIntegral = accelerationIntegral + accelerationPosition * cruiseTime + peakVelocity * cruiseTime * cruiseTime / 2;
+		endIntegral = cruiseIntegral + cruisePosition * accelerationTime
+				+ peakVelocity * accelerationTime * accelerationTime / 2
+				- acceleration * accelerationTime * accelerationTime * accelerationTime / 6;
+	}
+
+	/**
+	 * Длительность движения в секундах
+	 */
+	time_t getDuration() const {
+		return trapezoidTime + jerkTime;
+	}
+
+	/**
+	 * Расстояние со знаком
+	 */
+	float getDistance() const {
+		return direction * distance;
+	}
+
+	/**
+	 * Состояние в момент времени t от начала движения
+	 */
+	State getState(time_t t) const {
+		State state;
+		if (jerkTime <= 0) {
+			state.position = position(t);
+			state.velocity = velocity(t);
+			state.acceleration = accelerationAt(t);
+		} else {
+			// производные среднего по окну [t - jerkTime, t] - разности значений на концах окна
+			state.position = (integral(t) - integral(t - jerkTime)) / jerkTime;
+			state.velocity = (position(t) - position(t - jerkTime)) / jerkTime;
+			state.acceleration = (velocity(t) - velocity(t - jerkTime)) / jerkTime;
+		}
+		state.position *= direction;
+		state.velocity *= direction;
+		state.acceleration *= direction;
+		return state;
+	}
+
+private:
+	float position(time_t t) const {
+		if (t <= 0) {
+			return 0;
+		}
+		if (t < accelerationTime) {
+			return acceleration * t * t / 2;
+		}
+		if (t < accelerationTime + cruiseTime) {
+			return accelerationPosition + peakVelocity * (t - accelerationTime);
+		}
+		if (t < trapezoidTime) {
+			const float u = t - accelerationTime - cruiseTime;
+			return cruisePosition + peakVelocity * u - acceleration * u * u / 2;
+		}
+		return distance;
+	}
+
+	float velocity(time_t t) const {
+		if (t <= 0 || t >= trapezoidTime) {
+			return 0;
+		}
+		if (t < accelerationTime) {
+			return acceleration * t;
+		}
+		if (t < accelerationTime + cruiseTime) {
+			return peakVelocity;
+		}
+		return acceleration * (trapezoidTime - t);
+	}
+
+	float accelerationAt(time_t t) const {
+		if (t <= 0 || t >= trapezoidTime) {
+			return 0;
+		}
+		if (t < accelerationTime) {
+			return acceleration;
+		}
+		if (t < accelerationTime + cruiseTime) {
+			return 0;
+		}
+		return -acceleration;
+	}
+
+	/**
+	 * Интеграл положения от 0 до t
+	 */
+	float integral(time_t t) const {
+		if (t <= 0) {
+			return 0;
+		}
+		if (t < accelerationTime) {
+			return acceleration * t * t * t / 6;
+		}
+		if (t < accelerationTime + cruiseTime) {
+			const float u = t - accelerationTime;
+			return accelerationIntegral + accelerationPosition * u + peakVelocity * u * u / 2;
+		}
+		if (t < trapezoidTime) {
+			const float u = t - accelerationTime - cruiseTime;
+			return cruiseIntegral + cruisePosition * u + peakVelocity * u * u / 2 - acceleration * u * u * u / 6;
+		}
+		return endIntegral + distance * (t - trapezoidTime);
+	}
+
+	float direction;
+	float distance;
+	float acceleration;
+	float peakVelocity;
+	time_t accelerationTime;
+	time_t cruiseTime;
+	time_t trapezoidTime;
+	time_t jerkTime;
+
+	float accelerationPosition;
+	float cruisePosition;
+	float accelerationIntegral;
+	float cruiseIntegral;
+	float endIntegral;
+};
+
+} /* namespace ev3 */
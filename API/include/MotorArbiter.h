@@ -0,0 +1,479 @@
+/*
+ * MotorArbiter.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Motor.h"
+#include "Clock.h"
+#include "Process.h"
+#include "processes/ProcessGroup.hpp"
+#include "processes/ProcessSequence.hpp"
+#include "PortIndex.h"
+
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace ev3 {
+
+/**
+ * Доступ к проводам мощности мотора. Провода - защищённые члены Motor; указатель на член,
+ * полученный через производный класс, позволяет читать и снимать их, не меняя класс мотора библиотеки.
+ */
+struct MotorOutputAccess : Motor {
+	/**
+	 * Провод мощности, установленный на мотор. Каждый вызов setPower устанавливает новый провод,
+	 * поэтому по указателю можно узнать, писал ли кто-нибудь в мотор.
+	 */
+	static const std::shared_ptr<WireI>& getPowerOutput(const Motor &motor) {
+		std::shared_ptr<WireI> Motor::* powerOutput = &MotorOutputAccess::powerOutput;
+		return motor.*powerOutput;
+	}
+
+	/**
+	 * Снять провода мощности и скорости: мотор перестаёт получать команды из программы
+	 * (например, пока им управляет прошивка)
+	 */
+	static void detach(Motor &motor) {
+		std::shared_ptr<WireI> Motor::* powerOutput = &MotorOutputAccess::powerOutput;
+		std::shared_ptr<WireI> Motor::* speedOutput = &MotorOutputAccess::speedOutput;
+		(motor.*powerOutput).reset();
+		(motor.*speedOutput).reset();
+	}
+};
+
+/**
+ * Распределение управления мотором между процессами, выполняющимися одновременно.
+ * Без арбитра процессы пишут в мотор напрямую, и на каждом такте побеждает тот, кто обновился
+ * последним, - результат зависит от порядка процессов в группе.
+ *
+ * Процесс получает токен владения с приоритетом (acquire) и передаёт арбитру свою команду (command).
+ * На мотор устанавливается провод арбитра, который вычисляет только команду владельца: токена
+ * с наибольшим приоритетом, при равных приоритетах - полученного позже. Так вложенный процесс
+ * с тем же приоритетом (например, остановка внутри движения Move) управляет мотором, пока выполняется,
+ * а после его освобождения более старые команды того же приоритета не возвращаются: мотор сохраняет
+ * последнюю мощность до новой команды. Команды остальных процессов не вычисляются.
+ * После освобождения всех токенов мотор тоже сохраняет последнюю мощность, как после обычного setPower.
+ *
+ * Владелец токена отмечает его на каждом такте (touch). Токен, который не отмечался больше такта,
+ * брошен (например, процесс прерван группой &, которая не вызывает onCompleted у незавершённых процессов):
+ * он не участвует в выборе владельца, и его место может занять новый токен.
+ *
+ * Провод арбитра устанавливается на мотор один раз и сам выбирает команду владельца на каждом такте,
+ * поэтому смена владельца или значения команды не требует записи в мотор. Провод устанавливается
+ * заново, только если его заменил кто-то другой (см. isApplied).
+ *
+ * Провод арбитра ссылается на арбитра, поэтому арбитр должен существовать, пока установлен на моторе.
+ * Арбитры, полученные через MotorArbiter::of, существуют до конца программы.
+ */
+class MotorArbiter {
+public:
+	/**
+	 * Токен: место владельца и номер получения, поэтому освобождение старого токена
+	 * не освобождает новый токен на том же месте
+	 */
+	typedef int Token;
+
+	static constexpr Token NO_TOKEN = -1;
+	static const int MAX_OWNERS = 8;
+
+	explicit MotorArbiter(MotorPtr motor)
+	: motor(std::move(motor)) {
+	}
+
+	/**
+	 * Арбитр мотора. Для каждого порта создаётся один арбитр, повторные вызовы возвращают его же.
+	 * @param motor мотор
+	 * @return арбитр
+	 */
+	static std::shared_ptr<MotorArbiter> of(const MotorPtr &motor) {
+		static std::shared_ptr<MotorArbiter> arbiters[4];
+		std::shared_ptr<MotorArbiter> &arbiter = arbiters[portIndex(motor->getPort())];
+		if (!arbiter) {
+			arbiter = std::make_shared<MotorArbiter>(motor);
+		}
+		// замена арбитра потеряла бы токены процессов, которые его уже используют;
+		// мотор порта создаётся EV3 один раз, другой объект на том же порту - ошибка программы
+		assert(arbiter->motor == motor);
+		return arbiter;
+	}
+
+	/**
+	 * Получить токен владения
+	 * @param priority приоритет, чем больше, тем важнее
+	 * @return токен или NO_TOKEN, если все токены заняты
+	 */
+	Token acquire(int priority) {
+		for (int slot = 0; slot < MAX_OWNERS; ++slot) {
+			Owner &owner = owners[slot];
+			if (!owner.active || isAbandoned(owner)) {
+				owner.active = true;
+				owner.hasCommand = false;
+				owner.priority = priority;
+				owner.order = nextOrder++;
+				owner.commandOrder = 0;
+				owner.epoch = Clock::epoch();
+				owner.output = WireI(0);
+				owner.token = (Token)((owner.order & 0x0FFFFFFF) * MAX_OWNERS + slot);
+				return owner.token;
+			}
+		}
+		return NO_TOKEN;
+	}
+
+	/**
+	 * Освободить токен. Если токен был владельцем, мотор сохраняет его последнюю мощность до новой команды,
+	 * в том числе от токенов того же приоритета, которые командовали раньше него.
+	 */
+	void release(Token token) {
+		if (!isActive(token)) {
+			return;
+		}
+		Owner &released = owners[slotOf(token)];
+		if (owns(token)) {
+			for (Owner &owner : owners) {
+				if (owner.active && owner.hasCommand && owner.priority == released.priority
+						&& (int32_t)(owner.commandOrder - released.commandOrder) < 0) {
+					owner.hasCommand = false;
+				}
+			}
+		}
+		released.active = false;
+		released.hasCommand = false;
+		released.output = WireI(0);
+	}
+
+	/**
+	 * Отметка о том, что владелец токена ещё выполняется (см. isAbandoned). Вызывается на каждом такте.
+	 */
+	void touch(Token token) {
+		if (isActive(token)) {
+			owners[slotOf(token)].epoch = Clock::epoch();
+		}
+	}
+
+	/**
+	 * Команда процесса, владеющего токеном. Провод вычисляется, только если токен - владелец мотора.
+	 */
+	void command(Token token, const WireI &output) {
+		if (!isActive(token)) {
+			return;
+		}
+		Owner &owner = owners[slotOf(token)];
+		owner.output = output;
+		owner.hasCommand = true;
+		owner.commandOrder = nextOrder++;
+	}
+
+	void command(Token token, int power) {
+		command(token, WireI(power));
+	}
+
+	/**
+	 * Последняя команда токена. Если команды ещё не было - последняя мощность мотора.
+	 */
+	WireI getCommand(Token token) const {
+		if (isActive(token) && owners[slotOf(token)].hasCommand) {
+			return owners[slotOf(token)].output;
+		}
+		return WireI(lastPower);
+	}
+
+	/**
+	 * Текущий владелец мотора: активный и не брошенный токен с командой, наибольшим приоритетом
+	 * и полученный позже других
+	 * @return токен или NO_TOKEN
+	 */
+	Token getOwner() const {
+		return selectOwner(1);
+	}
+
+	bool owns(Token token) const {
+		return token != NO_TOKEN && getOwner() == token;
+	}
+
+	/**
+	 * Мощность, которую арбитр передаёт мотору
+	 */
+	int getPower() {
+		// провод вычисляется в updateOutputs, после обновления всех процессов такта,
+		// поэтому токен, не отмеченный на этом такте, уже брошен
+		const Token owner = selectOwner(0);
+		if (owner != NO_TOKEN) {
+			lastPower = owners[slotOf(owner)].output.getValue();
+		}
+		return lastPower;
+	}
+
+	/**
+	 * Устанавливает на мотор провод арбитра. Вызывается после того, как процесс записал в мотор напрямую.
+	 */
+	void apply() {
+		motor->setPower(WireI([this] { return getPower(); }));
+		installed = MotorOutputAccess::getPowerOutput(*motor);
+	}
+
+	/**
+	 * На моторе установлен провод арбитра
+	 */
+	bool isApplied() const {
+		return installed && MotorOutputAccess::getPowerOutput(*motor) == installed;
+	}
+
+	/**
+	 * Провод, установленный арбитром (для сравнения с текущим проводом мотора)
+	 */
+	const std::shared_ptr<WireI>& getInstalled() const {
+		return installed;
+	}
+
+	const MotorPtr& getMotor() const {
+		return motor;
+	}
+
+private:
+	struct Owner {
+		bool active = false;
+		bool hasCommand = false;
+		int priority = 0;
+		Token token = NO_TOKEN;
+		uint32_t order = 0;
+		uint32_t commandOrder = 0;
+		uint32_t epoch = 0;
+		WireI output { 0 };
+	};
+
+	/**
+	 * Владелец среди токенов, отмеченных не раньше чем maxAge тактов назад
+	 */
+	Token selectOwner(int maxAge) const {
+		const Owner *best = nullptr;
+		for (const Owner &owner : owners) {
+			if (!owner.active || !owner.hasCommand || isAbandoned(owner, maxAge)) {
+				continue;
+			}
+			if (best == nullptr || owner.priority > best->priority
+					|| (owner.priority == best->priority && (int32_t)(owner.order - best->order) > 0)) {
+				best = &owner;
+			}
+		}
+		return best == nullptr ? NO_TOKEN : best->token;
+	}
+
+	static int slotOf(Token token) {
+		return token % MAX_OWNERS;
+	}
+
+	bool isActive(Token token) const {
+		return token >= 0 && owners[slotOf(token)].active && owners[slotOf(token)].token == token;
+	}
+
+	/**
+	 * Токен не отмечался больше maxAge тактов. Во время такта процессы, которые ещё не обновились,
+	 * отмечены на прошлом такте, поэтому по умолчанию допускается один такт. Номер такта меняется
+	 * только в цикле EV3::runProcess, поэтому вне его токены не бросаются.
+	 */
+	static bool isAbandoned(const Owner &owner, int maxAge = 1) {
+		return (int32_t)(Clock::epoch() - owner.epoch) > maxAge;
+	}
+
+	MotorPtr motor;
+	Owner owners[MAX_OWNERS];
+	uint32_t nextOrder = 0;
+	int lastPower = 0;
+	std::shared_ptr<WireI> installed;
+};
+
+/**
+ * Процесс, управляющий моторами через арбитров (см. MotorArbiter).
+ * Вложенный процесс пишет в моторы как обычно. Если за обновление процесс установил на мотор новый провод,
+ * он становится командой процесса, а на мотор снова устанавливается провод арбитра. Если процесс
+ * в мотор не писал, в мотор ничего не записывается: действует его прошлая команда. Поэтому результат
+ * не зависит от порядка процессов в группе, а мотор получает не больше одной записи арбитра за такт.
+ * Вложенные MotorClaimProcess на тех же моторах допустимы: провод внутреннего арбитра не считается
+ * командой внешнего процесса, а при равных приоритетах мотором управляет внутренний процесс. Если процесс снял провода с мотора (например, SyncDriveProcess отдаёт
+ * мотор прошивке), арбитр провод не возвращает.
+ */
+class MotorClaimProcess : public virtual Process {
+public:
+	static const int MAX_MOTORS = 4;
+
+	/**
+	 * @param process вложенный процесс
+	 * @param motors моторы, которыми управляет процесс (не больше MAX_MOTORS)
+	 * @param priority приоритет, чем больше, тем важнее
+	 */
+	MotorClaimProcess(std::shared_ptr<Process> process, std::initializer_list<MotorPtr> motors, int priority = 0)
+	: process(std::move(process)), numberOfMotors(0), priority(priority), completed(false) {
+		for (const MotorPtr &motor : motors) {
+			if (numberOfMotors < MAX_MOTORS) {
+				arbiters[numberOfMotors] = MotorArbiter::of(motor);
+				tokens[numberOfMotors] = MotorArbiter::NO_TOKEN;
+				numberOfMotors++;
+			}
+		}
+	}
+
+	~MotorClaimProcess() {
+		// процесс, прерванный группой, не получает onCompleted
+		release();
+	}
+
+	virtual void onStarted(time_t secondsFromStart) override {
+		Process::onStarted(secondsFromStart);
+		completed = false;
+		release();
+		for (int i = 0; i < numberOfMotors; ++i) {
+			tokens[i] = arbiters[i]->acquire(priority);
+		}
+	}
+
+	virtual void update(time_t secondsFromStart) override {
+		Process::update(secondsFromStart);
+		if (completed) {
+			return;
+		}
+		// копии указателей удерживают провода, поэтому новый провод не может получить адрес старого
+		std::shared_ptr<WireI> before[MAX_MOTORS];
+		for (int i = 0; i < numberOfMotors; ++i) {
+			arbiters[i]->touch(tokens[i]);
+			before[i] = MotorOutputAccess::getPowerOutput(*arbiters[i]->getMotor());
+		}
+		process->update(secondsFromStart);
+		for (int i = 0; i < numberOfMotors; ++i) {
+			const std::shared_ptr<WireI> &output = MotorOutputAccess::getPowerOutput(*arbiters[i]->getMotor());
+			if (!output) {
+				// провода сняты: мотором управляет прошивка
+				continue;
+			}
+			if (output != before[i] && output != arbiters[i]->getInstalled()) {
+				arbiters[i]->command(tokens[i], *output);
+			}
+			if (!arbiters[i]->isApplied()) {
+				arbiters[i]->apply();
+			}
+		}
+		if (process->isCompleted(secondsFromStart)) {
+			completed = true;
+			release();
+		}
+	}
+
+	virtual void onCompleted(time_t secondsFromStart) override {
+		process->onCompleted(secondsFromStart);
+		release();
+	}
+
+	virtual bool isCompleted(time_t) override {
+		return completed;
+	}
+
+	const std::shared_ptr<Process>& getProcess() const {
+		return process;
+	}
+
+	int getNumberOfMotors() const {
+		return numberOfMotors;
+	}
+
+	const MotorPtr& getMotor(int index) const {
+		return arbiters[index]->getMotor();
+	}
+
+	int getPriority() const {
+		return priority;
+	}
+
+protected:
+	void release() {
+		for (int i = 0; i < numberOfMotors; ++i) {
+			arbiters[i]->release(tokens[i]);
+			tokens[i] = MotorArbiter::NO_TOKEN;
+		}
+	}
+
+	std::shared_ptr<Process> process;
+	std::shared_ptr<MotorArbiter> arbiters[MAX_MOTORS];
+	MotorArbiter::Token tokens[MAX_MOTORS];
+	int numberOfMotors;
+	int priority;
+	bool completed;
+};
+
+/**
+ * Оборачивает процесс в MotorClaimProcess
+ */
+template<class ProcessClass>
+std::shared_ptr<MotorClaimProcess> claimMotors(std::shared_ptr<ProcessClass> process, std::initializer_list<MotorPtr> motors, int priority = 0) {
+	static_assert(std::is_base_of<Process, ProcessClass>::value);
+	return std::make_shared<MotorClaimProcess>(std::move(process), motors, priority);
+}
+
+/**
+ * Конфликт: процессы, выполняющиеся одновременно, управляют одним мотором с одинаковым приоритетом.
+ * Арбитр отдаст мотор тому, кто позже получил токен, но, скорее всего, дерево процессов построено с ошибкой.
+ */
+struct MotorConflict {
+	Motor::Port port;
+	int priority;
+};
+
+/**
+ * Поиск конфликтов в дереве процессов. Учитываются только моторы, объявленные через MotorClaimProcess.
+ * Процессы групп (| и &) выполняются одновременно, процессы последовательности (>>) - по очереди.
+ * @param process корень дерева
+ * @return найденные конфликты
+ */
+inline std::vector<MotorConflict> findMotorConflicts(const std::shared_ptr<Process> &process) {
+	struct Claim {
+		const Motor *motor;
+		int priority;
+	};
+	struct Walker {
+		std::vector<MotorConflict> conflicts;
+
+		void collect(const std::shared_ptr<Process> &process, std::vector<Claim> &claims) {
+			if (!process) {
+				return;
+			}
+			if (auto claim = std::dynamic_pointer_cast<MotorClaimProcess>(process)) {
+				for (int i = 0; i < claim->getNumberOfMotors(); ++i) {
+					claims.push_back({ claim->getMotor(i).get(), claim->getPriority() });
+				}
+				collect(claim->getProcess(), claims);
+			} else if (auto group = std::dynamic_pointer_cast<ProcessGroup>(process)) {
+				std::vector<Claim> groupClaims;
+				for (const std::shared_ptr<Process> &member : group->getProcesses()) {
+					std::vector<Claim> memberClaims;
+					collect(member, memberClaims);
+					for (const Claim &memberClaim : memberClaims) {
+						for (const Claim &groupClaim : groupClaims) {
+							if (memberClaim.motor == groupClaim.motor && memberClaim.priority == groupClaim.priority) {
+								conflicts.push_back({ memberClaim.motor->getPort(), memberClaim.priority });
+							}
+						}
+					}
+					groupClaims.insert(groupClaims.end(), memberClaims.begin(), memberClaims.end());
+				}
+				claims.insert(claims.end(), groupClaims.begin(), groupClaims.end());
+			} else if (auto sequence = std::dynamic_pointer_cast<ProcessSequence>(process)) {
+				std::queue<std::shared_ptr<Process>> steps = sequence->getProcesses();
+				for (; !steps.empty(); steps.pop()) {
+					collect(steps.front(), claims);
+				}
+			}
+		}
+	};
+	Walker walker;
+	std::vector<Claim> claims;
+	walker.collect(process, claims);
+	return walker.conflicts;
+}
+
+} /* namespace ev3 */
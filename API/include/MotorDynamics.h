@@ -0,0 +1,149 @@
+/*
+ * MotorDynamics.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Motor.h"
+#include "Wire.h"
+#include "Clock.h"
+#include "PortIndex.h"
+#include "VelocityEstimator.h"
+
+#include <cassert>
+#include <memory>
+
+namespace ev3 {
+
+/**
+ * Динамика мотора: скорость и ускорение, вычисленные по энкодеру (см. VelocityEstimator),
+ * и постоянная времени для модели мотора первого порядка (см. getFeedforwardPower).
+ * Хранится отдельно от Motor, чтобы не менять класс мотора библиотеки.
+ *
+ * Оценка обновляется не чаще одного раза за такт при чтении, поэтому, пока скорость нужна,
+ * её следует читать на каждом такте.
+ */
+class MotorDynamics {
+public:
+	explicit MotorDynamics(MotorPtr motor)
+	: motor(std::move(motor)) {
+	}
+
+	/**
+	 * Динамика мотора. Для каждого порта создаётся один объект, который существует до конца программы.
+	 * @param motor мотор
+	 * @return динамика мотора
+	 */
+	static std::shared_ptr<MotorDynamics> of(const MotorPtr &motor) {
+		static std::shared_ptr<MotorDynamics> dynamics[4];
+		std::shared_ptr<MotorDynamics> &result = dynamics[portIndex(motor->getPort())];
+		if (!result) {
+			result = std::make_shared<MotorDynamics>(motor);
+		}
+		// мотор порта создаётся EV3 один раз; другой объект на том же порту - ошибка программы
+		assert(result->motor == motor);
+		return result;
+	}
+
+	/**
+	 * Скорость вращения
+	 * @return скорость в градусах за секунду
+	 */
+	float getVelocity() {
+		update();
+		return estimator.getVelocity();
+	}
+
+	/**
+	 * Ускорение вращения
+	 * @return ускорение в градусах за секунду в квадрате
+	 */
+	float getAcceleration() {
+		update();
+		return estimator.getAcceleration();
+	}
+
+	/**
+	 * Скорость вращения
+	 * @return провод со скоростью в градусах за секунду
+	 */
+	static WireF getVelocityWire(const MotorPtr &motor) {
+		std::shared_ptr<MotorDynamics> dynamics = of(motor);
+		return WireF([dynamics] { return dynamics->getVelocity(); });
+	}
+
+	/**
+	 * Ускорение вращения
+	 * @return провод с ускорением в градусах за секунду в квадрате
+	 */
+	static WireF getAccelerationWire(const MotorPtr &motor) {
+		std::shared_ptr<MotorDynamics> dynamics = of(motor);
+		return WireF([dynamics] { return dynamics->getAcceleration(); });
+	}
+
+	/**
+	 * Постоянная времени мотора: за это время скорость после изменения мощности
+	 * проходит примерно 63% пути до нового установившегося значения.
+	 * Используется для расчёта мощности, необходимой для ускорения (см. getFeedforwardPower).
+	 * По умолчанию используется значение 0.1
+	 * @param timeConstant время в секундах
+	 */
+	void setTimeConstant(float timeConstant) {
+		this->timeConstant = timeConstant;
+	}
+
+	float getTimeConstant() const {
+		return timeConstant;
+	}
+
+	/**
+	 * Мощность, необходимая для движения с заданными скоростью и ускорением, по модели мотора
+	 * первого порядка: power = startUpPower + 100 * (velocity + timeConstant * acceleration) / speedOnMaxPower.
+	 * Мощность трогания и скорость на максимальной мощности берутся из мотора
+	 * (см. Motor::getStartUpPower, Motor::getSpeedOnMaxPower).
+	 * Регулятору остаётся компенсировать только отклонение от модели.
+	 * @param velocity скорость в градусах за секунду
+	 * @param acceleration ускорение в градусах за секунду в квадрате
+	 * @return мощность без ограничения интервалом [-100, 100]
+	 */
+	float getFeedforwardPower(float velocity, float acceleration = 0) const {
+		const float speedOnMaxPower = motor->getSpeedOnMaxPower();
+		const float power = speedOnMaxPower > 0 ? (velocity + timeConstant * acceleration) * 100 / speedOnMaxPower : 0.0f;
+		if (velocity > 0) {
+			return power + motor->getStartUpPower();
+		}
+		if (velocity < 0) {
+			return power - motor->getStartUpPower();
+		}
+		return power;
+	}
+
+	/**
+	 * Установившаяся скорость при мощности 100 по модели мотора (см. getFeedforwardPower)
+	 * @return скорость в градусах за секунду
+	 */
+	float getFullPowerVelocity() const {
+		return motor->getSpeedOnMaxPower() * (100 - motor->getStartUpPower()) / 100;
+	}
+
+	const MotorPtr& getMotor() const {
+		return motor;
+	}
+
+private:
+	void update() {
+		if (estimator.epoch != Clock::epoch()) {
+			estimator.epoch = Clock::epoch();
+			estimator.update(Clock::tick(), motor->getEncoder());
+		}
+	}
+
+	MotorPtr motor;
+	VelocityEstimator<> estimator;
+	float timeConstant = 0.1f;
+};
+
+} /* namespace ev3 */
@@ -0,0 +1,34 @@
+/*
+ * PortIndex.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Motor.h"
+#include "Sensor.h"
+
+namespace ev3 {
+
+/**
+ * Номер порта мотора в массиве 0..3: порты моторов - биты OUT_A..OUT_D
+ */
+inline int portIndex(Motor::Port port) {
+	const unsigned bits = (unsigned)port;
+	int index = 0;
+	while ((bits >> index) > 1) {
+		index++;
+	}
+	return index;
+}
+
+/**
+ * Номер порта датчика в массиве 0..4: порты датчиков - числа IN_1..IN_4, за ними FAKE
+ */
+inline int portIndex(Sensor::Port port) {
+	return (int)port;
+}
+
+} /* namespace ev3 */
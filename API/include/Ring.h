@@ -7,7 +7,11 @@
 
 #pragma once
 
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 namespace ev3 {
 
@@ -17,8 +21,19 @@ public:
 	Ring()
 	: first(storage), next(storage) {
 	}
+	Ring(const Ring &other)
+	: first(storage + (other.first - other.storage)), next(storage + (other.next - other.storage)) {
+		std::copy(other.storage, other.storage + N+1, storage);
+	}
 	virtual ~Ring() = default;
 
+	Ring& operator=(const Ring &other) {
+		std::copy(other.storage, other.storage + N+1, storage);
+		first = storage + (other.first - other.storage);
+		next = storage + (other.next - other.storage);
+		return *this;
+	}
+
 	void push(T value) {
 		*next = std::move(value);
 		next++;
@@ -43,7 +58,8 @@ public:
 		return next - first;
 	}
 
-	void iterate(std::function<void(T&)> iteration) {
+	template<class Visitor>
+	void iterate(Visitor &&iteration) {
 		for (T* it = first; it != next;) {
 			iteration(*it);
 
@@ -58,6 +74,11 @@ public:
 		return *first;
 	}
 
+	void clear() {
+		first = storage;
+		next = storage;
+	}
+
 	static const int capacity = N;
 
 private:
@@ -67,4 +88,268 @@ private:
 	T* next;
 };
 
+/**
+ * Кольцевой буфер с накоплением статистики окна из N последних значений.
+ * Сумма, сумма квадратов, минимум и максимум обновляются при добавлении и вытеснении значений,
+ * поэтому среднее, дисперсия, минимум и максимум вычисляются за O(1).
+ * Минимум и максимум хранятся в монотонных очередях фиксированного размера (амортизированно O(1) на push).
+ */
+template<typename T, int N>
+class StatisticsRing {
+public:
+	typedef typename std::conditional<std::is_integral<T>::value, int64_t, T>::type Accumulator;
+
+	void push(T value) {
+		if (window.size() == N) {
+			const Accumulator evicted = window.firstValue();
+			sum -= evicted;
+			sumOfSquares -= evicted * evicted;
+		}
+		window.push(value);
+		sum += value;
+		sumOfSquares += (Accumulator)value * value;
+
+		const uint32_t index = numberOfPushes++;
+		if (index >= (uint32_t)N) {
+			minimums.evict(index - N);
+			maximums.evict(index - N);
+		}
+		minimums.push(value, index, [](T a, T b) { return a <= b; });
+		maximums.push(value, index, [](T a, T b) { return a >= b; });
+	}
+
+	int size() const {
+		return window.size();
+	}
+
+	Accumulator getSum() const {
+		return sum;
+	}
+
+	float getMean() const {
+		const int n = size();
+		return n == 0 ? 0.0f : (float)sum / n;
+	}
+
+	/**
+	 * Дисперсия значений в окне (смещённая оценка)
+	 */
+	float getVariance() const {
+		const int n = size();
+		if (n == 0) {
+			return 0.0f;
+		}
+		const float mean = (float)sum / n;
+		const float variance = (float)sumOfSquares / n - mean * mean;
+		return variance < 0 ? 0.0f : variance;
+	}
+
+	/**
+	 * Минимальное значение в окне. Для пустого окна не определено.
+	 */
+	T getMin() const {
+		return minimums.front();
+	}
+
+	/**
+	 * Максимальное значение в окне. Для пустого окна не определено.
+	 */
+	T getMax() const {
+		return maximums.front();
+	}
+
+	/**
+	 * Значения окна от самого старого к самому новому
+	 */
+	Ring<T, N>& values() {
+		return window;
+	}
+
+	void clear() {
+		window.clear();
+		sum = 0;
+		sumOfSquares = 0;
+		numberOfPushes = 0;
+		minimums.clear();
+		maximums.clear();
+	}
+
+	static const int capacity = N;
+
+private:
+	/**
+	 * Монотонная очередь: значения от начала к концу убывают (для максимума) или возрастают (для минимума)
+	 */
+	class MonotonicQueue {
+	public:
+		template<class Dominates>
+		void push(T value, uint32_t index, Dominates dominates) {
+			// удаляем с конца значения, которые уже никогда не станут экстремумом
+			while (count > 0 && dominates(value, values[back()])) {
+				count--;
+			}
+			const int position = wrap(first + count);
+			values[position] = value;
+			indices[position] = index;
+			count++;
+		}
+
+		void evict(uint32_t index) {
+			if (count > 0 && indices[first] == index) {
+				first = wrap(first + 1);
+				count--;
+			}
+		}
+
+		T front() const {
+			return values[first];
+		}
+
+		void clear() {
+			first = 0;
+			count = 0;
+		}
+
+	private:
+		static int wrap(int position) {
+			return position >= N ? position - N : position;
+		}
+
+		int back() const {
+			return wrap(first + count - 1);
+		}
+
+		T values[N];
+		uint32_t indices[N];
+		int first = 0;
+		int count = 0;
+	};
+
+	Ring<T, N> window;
+	Accumulator sum = 0;
+	Accumulator sumOfSquares = 0;
+	uint32_t numberOfPushes = 0;
+	MonotonicQueue minimums;
+	MonotonicQueue maximums;
+};
+
+/**
+ * Режим работы RingBuffer
+ */
+enum class RingMode {
+	SINGLE_THREAD, //!< запись и чтение в одном потоке, при переполнении вытесняется самое старое значение
+	SPSC,          //!< один поток пишет, другой читает; без блокировок, индексы с семантикой acquire/release
+};
+
+/**
+ * Кольцевой буфер с ёмкостью, равной степени двойки. Индексы - счётчики записанных и прочитанных
+ * значений, позиция в массиве вычисляется маской без сравнений и ветвлений.
+ *
+ * В режиме SPSC буфер можно использовать как очередь между двумя потоками, например, между потоком
+ * опроса датчиков и циклом управления или между циклом управления и записью лога. Писать может
+ * только один поток (tryPush), читать - только другой (tryPop, size, iterate).
+ */
+template<typename T, int N, RingMode mode = RingMode::SINGLE_THREAD>
+class RingBuffer {
+	static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+	/**
+	 * Добавляет значение. В однопоточном режиме при переполнении вытесняет самое старое значение.
+	 */
+	void push(T value) {
+		static_assert(mode == RingMode::SINGLE_THREAD, "push overwrites unread values and is not available in SPSC mode, use tryPush");
+		if (head - tail == (uint32_t)N) {
+			tail++;
+		}
+		storage[head & MASK] = std::move(value);
+		head++;
+	}
+
+	/**
+	 * Добавляет значение, если в буфере есть место. Вызывается только пишущим потоком.
+	 * @return false, если буфер заполнен
+	 */
+	bool tryPush(T value) {
+		const uint32_t h = load(head, std::memory_order_relaxed);
+		if (h - load(tail, std::memory_order_acquire) == (uint32_t)N) {
+			return false;
+		}
+		storage[h & MASK] = std::move(value);
+		store(head, h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Извлекает самое старое значение. Вызывается только читающим потоком.
+	 * @return false, если буфер пуст
+	 */
+	bool tryPop(T &value) {
+		const uint32_t t = load(tail, std::memory_order_relaxed);
+		if (load(head, std::memory_order_acquire) == t) {
+			return false;
+		}
+		value = std::move(storage[t & MASK]);
+		store(tail, t + 1, std::memory_order_release);
+		return true;
+	}
+
+	int size() const {
+		return (int)(load(head, std::memory_order_acquire) - load(tail, std::memory_order_relaxed));
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	/**
+	 * Обход значений от самого старого к самому новому
+	 * @param visitor функция, принимающая T&
+	 */
+	template<class Visitor>
+	void iterate(Visitor &&visitor) {
+		const uint32_t h = load(head, std::memory_order_acquire);
+		for (uint32_t i = load(tail, std::memory_order_relaxed); i != h; ++i) {
+			visitor(storage[i & MASK]);
+		}
+	}
+
+	T& firstValue() {
+		return storage[load(tail, std::memory_order_relaxed) & MASK];
+	}
+
+	/**
+	 * Последнее записанное значение. В режиме SPSC вызывается читающим потоком: чтение head с acquire
+	 * гарантирует, что значение уже записано пишущим потоком
+	 */
+	T& lastValue() {
+		return storage[(load(head, std::memory_order_acquire) - 1) & MASK];
+	}
+
+	void clear() {
+		store(tail, load(head, std::memory_order_acquire), std::memory_order_release);
+	}
+
+	static const int capacity = N;
+
+private:
+	static const uint32_t MASK = N - 1;
+	typedef typename std::conditional<mode == RingMode::SPSC, std::atomic<uint32_t>, uint32_t>::type Index;
+
+	static uint32_t load(const std::atomic<uint32_t> &index, std::memory_order order) { return index.load(order); }
+	static uint32_t load(const uint32_t &index, std::memory_order) { return index; }
+	static void store(std::atomic<uint32_t> &index, uint32_t value, std::memory_order order) { index.store(value, order); }
+	static void store(uint32_t &index, uint32_t value, std::memory_order) { index = value; }
+
+	T storage[N];
+	Index head { 0 };
+	Index tail { 0 };
+};
+
+/**
+ * Очередь без блокировок для одного пишущего и одного читающего потока
+ */
+template<typename T, int N>
+using SpscRing = RingBuffer<T, N, RingMode::SPSC>;
+
 } /* namespace ev3 */
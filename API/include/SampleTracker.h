@@ -0,0 +1,103 @@
+/*
+ * SampleTracker.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "common.h"
+#include "Clock.h"
+
+#include <cstdint>
+
+namespace ev3 {
+
+/**
+ * Отслеживание новых значений датчика. Датчики UART (например, датчик цвета в режиме RGB или
+ * инфракрасный датчик) обновляются реже, чем выполняется цикл управления, и на нескольких тактах подряд
+ * возвращают одно и то же значение. Фильтры и голосования, которые считают каждый такт, учитывают
+ * одно значение несколько раз.
+ *
+ * На каждом такте трекер получает счётчик обновлений источника (см. SensorMemory::getUpdateCounter).
+ * Если счётчик изменился, значение новое: увеличивается номер значения и запоминается время его получения.
+ * Первое значение после reset всегда новое.
+ */
+class SampleTracker {
+public:
+	/**
+	 * Обработка такта. Повторные вызовы в том же такте ничего не меняют.
+	 * @param epoch номер такта (см. Clock::epoch)
+	 * @param ticks время такта в микросекундах
+	 * @param counter счётчик обновлений источника
+	 */
+	void update(uint32_t epoch, ticks_t ticks, uint32_t counter) {
+		if (isUpdated(epoch)) {
+			return;
+		}
+		hasEpoch = true;
+		this->epoch = epoch;
+		fresh = !hasPrevious || counter != this->counter;
+		if (fresh) {
+			hasPrevious = true;
+			this->counter = counter;
+			sequence++;
+			timestamp = ticks;
+		}
+	}
+
+	/**
+	 * Такт уже обработан
+	 */
+	bool isUpdated(uint32_t epoch) const {
+		return hasEpoch && epoch == this->epoch;
+	}
+
+	/**
+	 * Значение получено на текущем такте
+	 */
+	bool isFresh() const {
+		return fresh;
+	}
+
+	/**
+	 * Номер последнего значения. Первое значение имеет номер 1.
+	 */
+	uint32_t getSequence() const {
+		return sequence;
+	}
+
+	/**
+	 * Время получения последнего значения в микросекундах
+	 */
+	ticks_t getTimestamp() const {
+		return timestamp;
+	}
+
+	/**
+	 * Возраст последнего значения в микросекундах
+	 */
+	ticks_t getAge(ticks_t ticks) const {
+		return ticks - timestamp;
+	}
+
+	void reset() {
+		hasEpoch = false;
+		hasPrevious = false;
+		fresh = false;
+		sequence = 0;
+		timestamp = 0;
+	}
+
+private:
+	uint32_t epoch = 0;
+	uint32_t counter = 0;
+	uint32_t sequence = 0;
+	ticks_t timestamp = 0;
+	bool hasEpoch = false;
+	bool hasPrevious = false;
+	bool fresh = false;
+};
+
+} /* namespace ev3 */
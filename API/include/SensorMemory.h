@@ -0,0 +1,355 @@
+/*
+ * SensorMemory.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Clock.h"
+#include "Sensor.h"
+#include "SensorSamples.h"
+#include "Wire.h"
+
+#include "core/ev3_analog.h"
+#include "core/ev3_iic.h"
+#include "core/ev3_uart.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ev3 {
+
+/**
+ * Чтение датчиков напрямую из разделяемой памяти драйверов прошивки (/dev/lms_analog, /dev/lms_uart,
+ * /dev/lms_iic) без вызова ReadSensor для каждого порта.
+ *
+ * Память отображается один раз (map, после SensorsInit), затем update за один проход проверяет счётчики
+ * обновлений всех четырёх портов (индекс последнего значения в журнале драйвера, Actual). Значение
+ * декодируется только для портов, на которых появились новые данные, остальные сохраняют прошлое значение.
+ * Способ подключения датчика (аналоговый, UART, IIC) определяется по InConn, как в ReadSensorData.
+ *
+ * Датчики библиотеки продолжают читать значения сами; SensorMemory подключается к ним через attach
+ * и даёт счётчики обновлений драйвера, по которым определяются новые значения (см. trackSamples).
+ *
+ * Для тестов на компьютере вместо отображения устройств можно передать свои области памяти
+ * (см. FakeSensorMemory).
+ */
+class SensorMemory {
+public:
+	static const int PORTS = INPUTS;
+	static const int RGB_BITS = 10;
+	static const int RGB_MAX = (1 << RGB_BITS) - 1;
+
+	SensorMemory() = default;
+
+	SensorMemory(ANALOG *analog, UART *uart, IIC *iic)
+	: analog(analog), uart(uart), iic(iic) {
+	}
+
+	SensorMemory(const SensorMemory&) = delete;
+	SensorMemory& operator=(const SensorMemory&) = delete;
+
+	~SensorMemory() {
+		unmap();
+	}
+
+	/**
+	 * Отображает разделяемую память драйверов датчиков. Вызывается после SensorsInit.
+	 * @return false, если хотя бы одно устройство не удалось отобразить
+	 */
+	bool map() {
+		unmap();
+		mapped = true;
+		analog = (ANALOG*)mapDevice("/dev/lms_analog", sizeof(ANALOG), analogFile);
+		uart = (UART*)mapDevice("/dev/lms_uart", sizeof(UART), uartFile);
+		iic = (IIC*)mapDevice("/dev/lms_iic", sizeof(IIC), iicFile);
+		return isMapped();
+	}
+
+	void unmap() {
+		if (!mapped) {
+			return;
+		}
+		unmapDevice(analog, sizeof(ANALOG), analogFile);
+		unmapDevice(uart, sizeof(UART), uartFile);
+		unmapDevice(iic, sizeof(IIC), iicFile);
+		mapped = false;
+	}
+
+	bool isMapped() const {
+		return analog != nullptr && uart != nullptr && iic != nullptr;
+	}
+
+	/**
+	 * Режим датчика определяет, как декодируются данные (размер и формат значения)
+	 */
+	void setMode(int port, Sensor::Mode mode) {
+		ports[port].mode = mode;
+		ports[port].counter = UINT32_MAX;
+	}
+
+	/**
+	 * Проверка счётчиков обновлений и декодирование новых значений
+	 * @return маска портов, на которых появились новые данные (бит i - порт i)
+	 */
+	uint32_t update() {
+		uint32_t updated = 0;
+		if (analog == nullptr) {
+			return updated;
+		}
+		for (int port = 0; port < PORTS; ++port) {
+			PortState &state = ports[port];
+			if (state.mode == Sensor::Mode::NO_SENSOR) {
+				continue;
+			}
+			const uint32_t counter = getUpdateCounter(port);
+			if (counter == state.counter) {
+				continue;
+			}
+			state.counter = counter;
+			state.value = decode(port);
+			state.numberOfUpdates++;
+			updated |= 1u << port;
+		}
+		epoch = Clock::epoch();
+		return updated;
+	}
+
+	/**
+	 * Последнее декодированное значение порта. В режиме COLOR_RGB три компонента упакованы
+	 * по RGB_BITS бит (см. getRGBComponent).
+	 */
+	int getValue(int port) const {
+		return ports[port].value;
+	}
+
+	/**
+	 * Количество новых значений порта с момента setMode
+	 */
+	uint32_t getNumberOfUpdates(int port) const {
+		return ports[port].numberOfUpdates;
+	}
+
+	/**
+	 * Значение порта в виде провода. Проверка счётчиков выполняется не чаще одного раза за такт.
+	 * SensorMemory должна существовать, пока используется провод.
+	 */
+	WireI getValueWire(int port) {
+		return WireI([this, port] {
+			if (epoch != Clock::epoch()) {
+				update();
+			}
+			return getValue(port);
+		});
+	}
+
+	/**
+	 * Компонент цвета из значения порта в режиме COLOR_RGB
+	 * @param value значение порта (см. getValue)
+	 * @param component 0 - r, 1 - g, 2 - b
+	 * @return необработанное значение датчика 0..RGB_MAX
+	 */
+	static int getRGBComponent(int value, int component) {
+		return (value >> ((2 - component) * RGB_BITS)) & RGB_MAX;
+	}
+
+	/**
+	 * Счётчик обновлений порта: индекс последнего значения в журнале драйвера
+	 */
+	uint32_t getUpdateCounter(int port) const {
+		switch (analog->InConn[port]) {
+		case CONN_INPUT_UART:
+			return uart->Actual[port];
+		case CONN_NXT_IIC:
+			return iic->Actual[port];
+		case CONN_NONE:
+		case CONN_ERROR:
+			return 0;
+		default:
+			return analog->Actual[port];
+		}
+	}
+
+	/**
+	 * Подключает счётчик обновлений порта к датчику, после этого SensorSamples::isNewSample точно определяет
+	 * новые значения. SensorMemory должна существовать, пока используется датчик.
+	 * FakeSensor не читает драйвер, и подключать его нельзя.
+	 */
+	void trackSamples(const SensorPtr &sensor) {
+		assert(sensor->getPort() != Sensor::Port::FAKE);
+		if (sensor->getPort() == Sensor::Port::FAKE) {
+			return;
+		}
+		const int port = (int)sensor->getPort();
+		SensorSamples::of(sensor)->setCounter([this, port] { return analog == nullptr ? 0u : getUpdateCounter(port); });
+	}
+
+	/**
+	 * Подключение датчика: режим декодирования по режиму датчика и счётчик обновлений (см. trackSamples).
+	 * FakeSensor подключать нельзя
+	 */
+	void attach(const SensorPtr &sensor) {
+		assert(sensor->getPort() != Sensor::Port::FAKE);
+		if (sensor->getPort() == Sensor::Port::FAKE) {
+			return;
+		}
+		setMode((int)sensor->getPort(), sensor->getMode());
+		trackSamples(sensor);
+	}
+
+	/**
+	 * Последние данные порта (до 32 байт) без копирования
+	 */
+	const void* getData(int port) const {
+		switch (analog->InConn[port]) {
+		case CONN_INPUT_UART:
+			return uart->Raw[port][uart->Actual[port]];
+		case CONN_NXT_IIC:
+			return iic->Raw[port][iic->Actual[port]];
+		case CONN_INPUT_DUMB:
+			return &analog->InPin6[port];
+		default:
+			return &analog->Pin1[port][analog->Actual[port]];
+		}
+	}
+
+protected:
+	struct PortState {
+		Sensor::Mode mode = Sensor::Mode::NO_SENSOR;
+		uint32_t counter = UINT32_MAX;
+		uint32_t numberOfUpdates = 0;
+		int value = 0;
+	};
+
+	int decode(int port) const {
+		const void *data = getData(port);
+		switch (ports[port].mode) {
+		case Sensor::Mode::NO_SENSOR:
+			return 0;
+		case Sensor::Mode::TOUCH:
+			// аналоговый датчик: напряжение на 6 контакте, нажатие - больше половины шкалы АЦП
+			return *(const int16_t*)data > TOUCH_THRESHOLD ? 1 : 0;
+		case Sensor::Mode::COLOR_REFLECT:
+		case Sensor::Mode::COLOR_AMBIENT:
+		case Sensor::Mode::COLOR_COLOR:
+		case Sensor::Mode::INFRARED_PROXIMITY:
+		case Sensor::Mode::NXT_INFRARED_SEEK:
+			return *(const uint8_t*)data;
+		case Sensor::Mode::COLOR_RGB: {
+			// три 16-битных значения r, g, b упаковываются по RGB_BITS бит (b - младшие биты).
+			// Датчик цвета EV3 возвращает компоненты 0..1023, поэтому упаковка не теряет данные;
+			// значения вне этого диапазона (не приходят от исправного датчика) ограничиваются
+			const int16_t *rgb = (const int16_t*)data;
+			return (clampComponent(rgb[0]) << (2 * RGB_BITS)) | (clampComponent(rgb[1]) << RGB_BITS) | clampComponent(rgb[2]);
+		}
+		default:
+			return *(const int16_t*)data;
+		}
+	}
+
+	static const int16_t TOUCH_THRESHOLD = 2048;
+
+	static int clampComponent(int value) {
+		return value < 0 ? 0 : (value > RGB_MAX ? RGB_MAX : value);
+	}
+
+	static void* mapDevice(const char *path, size_t size, int &file) {
+		file = ::open(path, O_RDWR | O_SYNC);
+		if (file < 0) {
+			return nullptr;
+		}
+		void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		if (memory == MAP_FAILED) {
+			::close(file);
+			file = -1;
+			return nullptr;
+		}
+		return memory;
+	}
+
+	template<typename T>
+	static void unmapDevice(T *&memory, size_t size, int &file) {
+		if (memory != nullptr) {
+			munmap(memory, size);
+			memory = nullptr;
+		}
+		if (file >= 0) {
+			::close(file);
+			file = -1;
+		}
+	}
+
+	ANALOG *analog = nullptr;
+	UART *uart = nullptr;
+	IIC *iic = nullptr;
+	bool mapped = false;
+	int analogFile = -1;
+	int uartFile = -1;
+	int iicFile = -1;
+
+	PortState ports[PORTS];
+	uint32_t epoch = UINT32_MAX;
+};
+
+/**
+ * Области памяти датчиков для тестов на компьютере. Методы set* записывают значение так же,
+ * как драйверы прошивки: в следующую ячейку журнала с переносом индекса Actual.
+ */
+class FakeSensorMemory {
+public:
+	FakeSensorMemory()
+	: analog(new ANALOG()), uart(new UART()), iic(new IIC()) {
+		for (int port = 0; port < INPUTS; ++port) {
+			analog->InConn[port] = CONN_NONE;
+		}
+	}
+
+	/**
+	 * Память для SensorMemory. FakeSensorMemory должна существовать, пока используется SensorMemory.
+	 */
+	std::unique_ptr<SensorMemory> createSensorMemory() {
+		return std::unique_ptr<SensorMemory>(new SensorMemory(analog.get(), uart.get(), iic.get()));
+	}
+
+	void setConnection(int port, CONN connection) {
+		analog->InConn[port] = connection;
+	}
+
+	void setAnalog(int port, int16_t value) {
+		const uint16_t actual = next(analog->Actual[port]);
+		analog->Pin1[port][actual] = value;
+		analog->InPin6[port] = value;
+		analog->Actual[port] = actual;
+	}
+
+	void setUart(int port, const void *data, size_t length) {
+		const uint16_t actual = next(uart->Actual[port]);
+		std::memcpy(uart->Raw[port][actual], data, length < UART_DATA_LENGTH ? length : UART_DATA_LENGTH);
+		uart->Actual[port] = actual;
+	}
+
+	void setIic(int port, const void *data, size_t length) {
+		const uint16_t actual = next(iic->Actual[port]);
+		std::memcpy(iic->Raw[port][actual], data, length < IIC_DATA_LENGTH ? length : IIC_DATA_LENGTH);
+		iic->Actual[port] = actual;
+	}
+
+private:
+	static uint16_t next(uint16_t actual) {
+		return actual + 1 >= DEVICE_LOGBUF_SIZE ? 0 : actual + 1;
+	}
+
+	std::unique_ptr<ANALOG> analog;
+	std::unique_ptr<UART> uart;
+	std::unique_ptr<IIC> iic;
+};
+
+} /* namespace ev3 */
@@ -0,0 +1,140 @@
+/*
+ * SensorSamples.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Sensor.h"
+#include "Wire.h"
+#include "Clock.h"
+#include "PortIndex.h"
+#include "SampleTracker.h"
+#include "InplaceFunction.h"
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ev3 {
+
+/**
+ * Новые значения датчика (см. SampleTracker). Хранится отдельно от Sensor, чтобы не менять класс датчика библиотеки.
+ *
+ * Счётчик обновлений подключает SensorMemory::trackSamples. Без счётчика новым считается значение
+ * на каждом такте - так же, как датчик читался без отслеживания. У FakeSensor счётчика нет.
+ */
+class SensorSamples {
+public:
+	explicit SensorSamples(SensorPtr sensor)
+	: sensor(std::move(sensor)) {
+	}
+
+	/**
+	 * Новые значения датчика. Для каждого порта создаётся один объект, который существует до конца программы.
+	 * Датчики FakeSensor все на порту FAKE и создаются при каждом вызове EV3::getFakeSensor, поэтому для них
+	 * объект ищется по самому датчику и существует, пока его используют.
+	 * @param sensor датчик
+	 * @return новые значения датчика
+	 */
+	static std::shared_ptr<SensorSamples> of(const SensorPtr &sensor) {
+		if (sensor->getPort() == Sensor::Port::FAKE) {
+			return ofFake(sensor);
+		}
+		static std::shared_ptr<SensorSamples> samples[4];
+		std::shared_ptr<SensorSamples> &result = samples[portIndex(sensor->getPort())];
+		if (!result) {
+			result = std::make_shared<SensorSamples>(sensor);
+		}
+		// датчик порта создаётся EV3 один раз; другой объект на том же порту - ошибка программы
+		assert(result->sensor == sensor);
+		return result;
+	}
+
+	/**
+	 * Источник счётчика обновлений датчика
+	 * @param counter функция, возвращающая счётчик обновлений драйвера
+	 */
+	void setCounter(const InplaceFunction<uint32_t()> &counter) {
+		this->counter = counter;
+		tracker.reset();
+	}
+
+	/**
+	 * Подключен счётчик обновлений (см. setCounter)
+	 */
+	bool hasCounter() const {
+		return (bool)counter;
+	}
+
+	/**
+	 * Значение датчика новое: счётчик обновлений изменился с прошлого такта, на котором выполнялась проверка
+	 */
+	bool isNewSample() {
+		update();
+		return tracker.isFresh();
+	}
+
+	/**
+	 * Номер последнего значения датчика
+	 */
+	uint32_t getSequence() {
+		update();
+		return tracker.getSequence();
+	}
+
+	/**
+	 * Время получения последнего значения датчика в микросекундах (см. Clock)
+	 */
+	ticks_t getTimestamp() {
+		update();
+		return tracker.getTimestamp();
+	}
+
+	/**
+	 * Провод, на котором true, если значение датчика новое (см. isNewSample)
+	 */
+	static WireB getNewSampleWire(const SensorPtr &sensor) {
+		std::shared_ptr<SensorSamples> samples = of(sensor);
+		return WireB([samples] { return samples->isNewSample(); });
+	}
+
+	const SensorPtr& getSensor() const {
+		return sensor;
+	}
+
+private:
+	static std::shared_ptr<SensorSamples> ofFake(const SensorPtr &sensor) {
+		static std::vector<std::weak_ptr<SensorSamples>> fakes;
+		for (size_t i = 0; i < fakes.size();) {
+			std::shared_ptr<SensorSamples> samples = fakes[i].lock();
+			if (!samples) {
+				fakes[i] = fakes.back();
+				fakes.pop_back();
+				continue;
+			}
+			if (samples->sensor == sensor) {
+				return samples;
+			}
+			++i;
+		}
+		std::shared_ptr<SensorSamples> result = std::make_shared<SensorSamples>(sensor);
+		fakes.push_back(result);
+		return result;
+	}
+
+	void update() {
+		if (!tracker.isUpdated(Clock::epoch())) {
+			tracker.update(Clock::epoch(), Clock::tick(), counter ? counter() : Clock::epoch());
+		}
+	}
+
+	SensorPtr sensor;
+	InplaceFunction<uint32_t()> counter;
+	SampleTracker tracker;
+};
+
+} /* namespace ev3 */
@@ -0,0 +1,121 @@
+/*
+ * VelocityEstimator.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "common.h"
+#include "Ring.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace ev3 {
+
+/**
+ * Оценка скорости и ускорения по значениям энкодера с метками времени.
+ * По N последним значениям методом наименьших квадратов строится парабола x(t) = c0 + c1 t + c2 t^2,
+ * время отсчитывается от последнего значения, поэтому скорость - c1, ускорение - 2 c2.
+ * В отличие от скорости, которую возвращает прошивка (целое число в интервале [-100, 100], с задержкой),
+ * оценка имеет разрешение долей градуса в секунду и учитывает реальные интервалы между тактами.
+ */
+template<int N = 8>
+class VelocityEstimator {
+public:
+	/**
+	 * Добавление значения энкодера
+	 * @param ticks время в микросекундах (см. Clock)
+	 * @param encoder значение энкодера в градусах
+	 */
+	void update(ticks_t ticks, int encoder) {
+		if (!samples.empty() && samples.lastValue().ticks == ticks) {
+			return;
+		}
+		samples.push({ ticks, encoder });
+		fit();
+	}
+
+	/**
+	 * Скорость в градусах за секунду
+	 */
+	float getVelocity() const {
+		return velocity;
+	}
+
+	/**
+	 * Ускорение в градусах за секунду в квадрате. Для вычисления нужно не меньше трёх значений.
+	 */
+	float getAcceleration() const {
+		return acceleration;
+	}
+
+	void reset() {
+		samples.clear();
+		velocity = 0;
+		acceleration = 0;
+	}
+
+	/**
+	 * Такт, на котором оценка обновлялась последний раз (см. Clock::epoch)
+	 */
+	uint32_t epoch = UINT32_MAX;
+
+private:
+	struct Sample {
+		ticks_t ticks;
+		int encoder;
+	};
+
+	void fit() {
+		const int n = samples.size();
+		if (n < 2) {
+			velocity = 0;
+			acceleration = 0;
+			return;
+		}
+		const Sample last = samples.lastValue();
+		// суммы степеней времени и произведений для нормальных уравнений
+		double s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+		double y0 = 0, y1 = 0, y2 = 0;
+		samples.iterate([&](const Sample &sample) {
+			const double t = ticksToSeconds(sample.ticks - last.ticks);
+			const double x = sample.encoder - last.encoder;
+			const double t2 = t * t;
+			s1 += t;
+			s2 += t2;
+			s3 += t2 * t;
+			s4 += t2 * t2;
+			y0 += x;
+			y1 += x * t;
+			y2 += x * t2;
+		});
+
+		if (n >= 3) {
+			// | n  s1 s2 |   | c0 |   | y0 |
+			// | s1 s2 s3 | * | c1 | = | y1 |
+			// | s2 s3 s4 |   | c2 |   | y2 |
+			const double det = n * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+			if (std::fabs(det) > 1e-18) {
+				const double c1 = (n * (y1 * s4 - s3 * y2) - y0 * (s1 * s4 - s3 * s2) + s2 * (s1 * y2 - y1 * s2)) / det;
+				const double c2 = (n * (s2 * y2 - y1 * s3) - s1 * (s1 * y2 - y1 * s2) + y0 * (s1 * s3 - s2 * s2)) / det;
+				velocity = (float)c1;
+				acceleration = (float)(2 * c2);
+				return;
+			}
+		}
+
+		// прямая x = c0 + c1 t
+		const double det = n * s2 - s1 * s1;
+		velocity = std::fabs(det) > 1e-18 ? (float)((n * y1 - s1 * y0) / det) : 0.0f;
+		acceleration = 0;
+	}
+
+	RingBuffer<Sample, N> samples;
+	float velocity = 0;
+	float acceleration = 0;
+};
+
+} /* namespace ev3 */
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "Clock.h"
+
 #include <functional>
 #include <memory>
 
@@ -63,10 +65,105 @@ public:
 		return provider();
 	}
 
+	/**
+	 * Провод, который вычисляет значение этого провода не чаще одного раза за такт.
+	 * Полезен, когда одно и то же выражение читают несколько потребителей.
+	 * @return кэширующий провод
+	 */
+	Wire<T> cached() const;
+
 protected:
 	std::function<T()> provider;
 };
 
+/**
+ * Общая статистика кэширующих проводов
+ */
+struct WireCacheStatistics {
+	/// количество фактических вычислений
+	static inline uint32_t evaluations = 0;
+	/// количество вычислений, которых удалось избежать
+	static inline uint32_t savedEvaluations = 0;
+};
+
+/**
+ * Кэширующий провод. Значение исходного провода вычисляется не чаще одного раза
+ * за такт (см. Clock::epoch), повторные чтения в том же такте возвращают сохранённое значение.
+ * Вне цикла EV3::runProcess (например, во время EV3::wait) такты не идут, и кэш не используется:
+ * каждое чтение вычисляет исходный провод.
+ */
+template<typename T>
+class CachedWire : public Wire<T> {
+public:
+	/**
+	 * Конструктор
+	 * @param source исходный провод
+	 */
+	explicit CachedWire(const Wire<T> & source)
+		: CachedWire(std::make_shared<State>(source))
+	{
+	}
+
+	/**
+	 * Количество фактических вычислений исходного провода
+	 */
+	uint32_t getNumberOfEvaluations() const
+	{
+		return state->evaluations;
+	}
+
+	/**
+	 * Количество чтений, для которых было использовано значение из кэша
+	 */
+	uint32_t getNumberOfSavedEvaluations() const
+	{
+		return state->savedEvaluations;
+	}
+
+protected:
+	struct State {
+		explicit State(const Wire<T> & source)
+			: source(source)
+		{
+		}
+
+		T getValue()
+		{
+			uint32_t epoch = Clock::epoch();
+			if (Clock::isTicking() && evaluations > 0 && epoch == valueEpoch) {
+				savedEvaluations++;
+				WireCacheStatistics::savedEvaluations++;
+				return value;
+			}
+			value = source.getValue();
+			valueEpoch = epoch;
+			evaluations++;
+			WireCacheStatistics::evaluations++;
+			return value;
+		}
+
+		Wire<T> source;
+		T value = T();
+		uint32_t valueEpoch = 0;
+		uint32_t evaluations = 0;
+		uint32_t savedEvaluations = 0;
+	};
+
+	explicit CachedWire(const std::shared_ptr<State> & state)
+		: Wire<T>([state] { return state->getValue(); })
+		, state(state)
+	{
+	}
+
+	std::shared_ptr<State> state;
+};
+
+template<typename T>
+Wire<T> Wire<T>::cached() const
+{
+	return CachedWire<T>(*this);
+}
+
 /**
  * Оператор сложения для проводов
  * @param w1
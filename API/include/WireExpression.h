@@ -0,0 +1,273 @@
+/*
+ * WireExpression.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Wire.h"
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+namespace ev3 {
+
+/**
+ * Выражение над проводами, которое хранится как конкретный тип (expression template).
+ * В отличие от операторов Wire, каждый узел не создаёт новую std::function:
+ * всё выражение вычисляется одним встраиваемым вызовом и превращается в Wire
+ * только один раз - при передаче в Motor::setPower, PID::setError и т.п.
+ *
+ * Пример:
+ *   motor->setPower(wireExpr(leftLight) - wireExpr(rightLight) * 2);
+ */
+template<class Derived>
+class WireExpression {
+public:
+	/**
+	 * Превращение выражения в провод. Единственное место, где выражение упаковывается в std::function.
+	 */
+	template<typename V>
+	operator Wire<V>() const
+	{
+		Derived expression = static_cast<const Derived &>(*this);
+		return Wire<V>(std::function<V()>([expression] { return (V)expression.getValue(); }));
+	}
+
+	/**
+	 * Превращение выражения в провод с типом значения выражения
+	 */
+	auto toWire() const
+	{
+		return (Wire<typename Derived::value_type>)*this;
+	}
+};
+
+template<class E>
+constexpr bool isWireExpression = std::is_base_of<WireExpression<std::decay_t<E>>, std::decay_t<E>>::value;
+
+/**
+ * Лист выражения - произвольная функция без аргументов
+ */
+template<class F>
+class WireTerm : public WireExpression<WireTerm<F>> {
+public:
+	using value_type = std::decay_t<decltype(std::declval<const F &>()())>;
+
+	explicit WireTerm(F function)
+		: function(std::move(function))
+	{
+	}
+
+	inline value_type getValue() const
+	{
+		return function();
+	}
+
+protected:
+	F function;
+};
+
+/**
+ * Лист выражения - постоянное значение
+ */
+template<typename T>
+class WireConstant : public WireExpression<WireConstant<T>> {
+public:
+	using value_type = T;
+
+	explicit WireConstant(const T & value)
+		: value(value)
+	{
+	}
+
+	inline T getValue() const
+	{
+		return value;
+	}
+
+protected:
+	T value;
+};
+
+/**
+ * Узел выражения - бинарная операция
+ */
+template<class L, class R, class Operation>
+class WireBinaryExpression : public WireExpression<WireBinaryExpression<L, R, Operation>> {
+public:
+	using value_type = std::decay_t<decltype(Operation()(std::declval<const L &>().getValue(), std::declval<const R &>().getValue()))>;
+
+	WireBinaryExpression(L left, R right)
+		: left(std::move(left))
+		, right(std::move(right))
+	{
+	}
+
+	inline value_type getValue() const
+	{
+		return Operation()(left.getValue(), right.getValue());
+	}
+
+protected:
+	L left;
+	R right;
+};
+
+/**
+ * Лист выражения - провод. Провод вычисляется через свою функцию, остальная часть выражения - без упаковки.
+ */
+template<typename T>
+class WireSource : public WireExpression<WireSource<T>> {
+public:
+	using value_type = T;
+
+	explicit WireSource(const Wire<T> & wire)
+		: wire(wire)
+	{
+	}
+
+	inline T getValue() const
+	{
+		return wire.getValue();
+	}
+
+protected:
+	Wire<T> wire;
+};
+
+/**
+ * Лист выражения - устройство с методом getValue (например, датчик). Значение читается напрямую,
+ * без промежуточного провода.
+ */
+template<typename D>
+class DeviceSource : public WireExpression<DeviceSource<D>> {
+public:
+	using value_type = std::decay_t<decltype(std::declval<const D &>().getValue())>;
+
+	explicit DeviceSource(std::shared_ptr<D> device)
+		: device(std::move(device))
+	{
+	}
+
+	inline value_type getValue() const
+	{
+		return device->getValue();
+	}
+
+protected:
+	std::shared_ptr<D> device;
+};
+
+/**
+ * Начало выражения из провода
+ * @param wire провод
+ * @return лист выражения
+ */
+template<typename T>
+inline WireSource<T> wireExpr(const Wire<T> & wire)
+{
+	return WireSource<T>(wire);
+}
+
+/**
+ * Начало выражения из датчика
+ * @param device умный указатель на устройство
+ * @return лист выражения
+ */
+template<typename D, typename = decltype(std::declval<const D &>().getValue())>
+inline DeviceSource<D> wireExpr(const std::shared_ptr<D> & device)
+{
+	return DeviceSource<D>(device);
+}
+
+/**
+ * Начало выражения из функции без аргументов
+ * @param function функция (лямбда)
+ * @return лист выражения
+ */
+template<class F, typename = decltype(std::declval<const F &>()())>
+inline WireTerm<F> wireExpr(F function)
+{
+	return WireTerm<F>(std::move(function));
+}
+
+namespace detail {
+
+template<class E>
+inline const E & asWireExpression(const E & expression, std::true_type)
+{
+	return expression;
+}
+
+template<typename T>
+inline WireConstant<T> asWireExpression(const T & value, std::false_type)
+{
+	return WireConstant<T>(value);
+}
+
+template<typename T>
+inline WireSource<T> asWireExpression(const Wire<T> & wire)
+{
+	return WireSource<T>(wire);
+}
+
+template<class E>
+inline auto asWireExpression(const E & value)
+{
+	return asWireExpression(value, std::integral_constant<bool, isWireExpression<E>>());
+}
+
+template<class A, class B>
+using EnableIfWireExpression = std::enable_if_t<isWireExpression<A> || isWireExpression<B>>;
+
+template<class Operation, class A, class B>
+inline auto makeWireBinaryExpression(const A & a, const B & b)
+{
+	auto left = asWireExpression(a);
+	auto right = asWireExpression(b);
+	return WireBinaryExpression<decltype(left), decltype(right), Operation>(left, right);
+}
+
+} /* namespace detail */
+
+/**
+ * Сложение выражений (или выражения и значения)
+ */
+template<class A, class B, typename = detail::EnableIfWireExpression<A, B>>
+inline auto operator+(const A & a, const B & b)
+{
+	return detail::makeWireBinaryExpression<std::plus<>>(a, b);
+}
+
+/**
+ * Вычитание выражений (или выражения и значения)
+ */
+template<class A, class B, typename = detail::EnableIfWireExpression<A, B>>
+inline auto operator-(const A & a, const B & b)
+{
+	return detail::makeWireBinaryExpression<std::minus<>>(a, b);
+}
+
+/**
+ * Умножение выражений (или выражения и значения)
+ */
+template<class A, class B, typename = detail::EnableIfWireExpression<A, B>>
+inline auto operator*(const A & a, const B & b)
+{
+	return detail::makeWireBinaryExpression<std::multiplies<>>(a, b);
+}
+
+/**
+ * Деление выражений (или выражения и значения)
+ */
+template<class A, class B, typename = detail::EnableIfWireExpression<A, B>>
+inline auto operator/(const A & a, const B & b)
+{
+	return detail::makeWireBinaryExpression<std::divides<>>(a, b);
+}
+
+} /* namespace ev3 */
@@ -0,0 +1,315 @@
+/*
+ * WireFilters.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Clock.h"
+#include "Ring.h"
+#include "Sensor.h"
+#include "SensorSamples.h"
+#include "Wire.h"
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+namespace ev3 {
+
+/**
+ * Потоковые фильтры. Каждый фильтр хранит состояние фиксированного размера и обрабатывает
+ * новое значение за O(1) (медиана - за O(N) для небольшого N без выделения памяти).
+ * Все фильтры имеют метод update(sample, ticks), поэтому их можно использовать напрямую
+ * в процессах или подключить к проводу через filterWire.
+ */
+
+/**
+ * Экспоненциальное скользящее среднее: y = y + alpha * (x - y)
+ */
+template<typename T>
+class ExponentialMovingAverage {
+public:
+	/**
+	 * @param alpha коэффициент сглаживания в интервале (0, 1]. Чем меньше, тем сильнее сглаживание
+	 */
+	explicit ExponentialMovingAverage(float alpha)
+	: alpha(alpha) {
+	}
+
+	float update(T sample, ticks_t ticks) {
+		if (empty) {
+			value = sample;
+			empty = false;
+		} else {
+			value += alpha * (sample - value);
+		}
+		return value;
+	}
+
+	float getValue() const { return value; }
+
+	void reset() { empty = true; value = 0; }
+
+private:
+	float alpha;
+	float value = 0;
+	bool empty = true;
+};
+
+/**
+ * Среднее значение в окне из N последних значений
+ */
+template<typename T, int N>
+class RunningMean {
+public:
+	float update(T sample, ticks_t ticks) {
+		window.push(sample);
+		return window.getMean();
+	}
+
+	float getValue() const {
+		return window.getMean();
+	}
+
+	int size() const { return window.size(); }
+
+	void reset() { window.clear(); }
+
+private:
+	StatisticsRing<T, N> window;
+};
+
+/**
+ * Медиана в окне из N последних значений. Устойчива к единичным выбросам.
+ * Значения хранятся в кольцевом буфере (порядок поступления) и в отсортированном массиве,
+ * обновление - сдвиг в отсортированном массиве, O(N).
+ */
+template<typename T, int N>
+class RunningMedian {
+public:
+	T update(T sample, ticks_t ticks) {
+		int size = window.size();
+		if (size == N) {
+			// удаляем самое старое значение из отсортированного массива
+			T evicted = window.firstValue();
+			int i = 0;
+			while (sorted[i] != evicted) {
+				++i;
+			}
+			for (; i + 1 < size; ++i) {
+				sorted[i] = sorted[i + 1];
+			}
+			size--;
+		}
+		window.push(sample);
+		int i = size;
+		while (i > 0 && sample < sorted[i - 1]) {
+			sorted[i] = sorted[i - 1];
+			--i;
+		}
+		sorted[i] = sample;
+		return getValue();
+	}
+
+	T getValue() const {
+		int size = window.size();
+		return size == 0 ? T() : sorted[size / 2];
+	}
+
+	void reset() { window.clear(); }
+
+private:
+	Ring<T, N> window;
+	T sorted[N];
+};
+
+/**
+ * Гистерезис: выход включается, когда значение выше верхнего порога, и выключается,
+ * когда значение ниже нижнего порога. Между порогами сохраняется предыдущее состояние.
+ */
+template<typename T>
+class Hysteresis {
+public:
+	Hysteresis(T lowThreshold, T highThreshold, bool initialState = false)
+	: lowThreshold(lowThreshold), highThreshold(highThreshold), state(initialState) {
+	}
+
+	bool update(T sample, ticks_t ticks) {
+		if (state && sample < lowThreshold) {
+			state = false;
+		} else if (!state && sample > highThreshold) {
+			state = true;
+		}
+		return state;
+	}
+
+	bool getValue() const { return state; }
+
+private:
+	T lowThreshold;
+	T highThreshold;
+	bool state;
+};
+
+/**
+ * Подавление дребезга: выход меняется, только если вход держит новое значение
+ * не меньше заданного времени.
+ */
+class Debounce {
+public:
+	/**
+	 * @param stableTicks время в микросекундах, в течение которого значение должно быть стабильным
+	 */
+	explicit Debounce(ticks_t stableTicks, bool initialState = false)
+	: stableTicks(stableTicks), state(initialState), candidate(initialState) {
+	}
+
+	bool update(bool sample, ticks_t ticks) {
+		if (sample == state) {
+			candidate = state;
+			return state;
+		}
+		if (sample != candidate) {
+			candidate = sample;
+			candidateTicks = ticks;
+		}
+		if (ticks - candidateTicks >= stableTicks) {
+			state = candidate;
+		}
+		return state;
+	}
+
+	bool getValue() const { return state; }
+
+private:
+	ticks_t stableTicks;
+	bool state;
+	bool candidate;
+	ticks_t candidateTicks = 0;
+};
+
+/**
+ * Ограничение скорости изменения значения
+ */
+template<typename T>
+class RateLimiter {
+public:
+	/**
+	 * @param maxRate максимальное изменение значения за секунду
+	 */
+	explicit RateLimiter(float maxRate)
+	: maxRate(maxRate) {
+	}
+
+	float update(T sample, ticks_t ticks) {
+		if (empty) {
+			value = sample;
+			empty = false;
+		} else {
+			float maxDelta = maxRate * ticksToSeconds(ticks - prevTicks);
+			float delta = sample - value;
+			value += delta > maxDelta ? maxDelta : (delta < -maxDelta ? -maxDelta : delta);
+		}
+		prevTicks = ticks;
+		return value;
+	}
+
+	float getValue() const { return value; }
+
+private:
+	float maxRate;
+	float value = 0;
+	ticks_t prevTicks = 0;
+	bool empty = true;
+};
+
+/**
+ * Производная по времени (изменение значения за секунду)
+ */
+template<typename T>
+class Derivative {
+public:
+	float update(T sample, ticks_t ticks) {
+		if (!empty && ticks > prevTicks) {
+			value = (sample - prevSample) * (float)TICKS_PER_SECOND / (ticks - prevTicks);
+		}
+		empty = false;
+		prevSample = sample;
+		prevTicks = ticks;
+		return value;
+	}
+
+	float getValue() const { return value; }
+
+private:
+	T prevSample = T();
+	ticks_t prevTicks = 0;
+	float value = 0;
+	bool empty = true;
+};
+
+/**
+ * Подключает фильтр к проводу. Фильтр получает новое значение не чаще одного раза за такт
+ * (см. Clock::epoch), повторные чтения в том же такте возвращают сохранённый результат.
+ * Если провод не читали на каком-то такте, фильтр этот такт пропускает.
+ * @param source исходный провод
+ * @param filter фильтр
+ * @return провод с отфильтрованными значениями
+ */
+template<typename T, class Filter>
+auto filterWire(const Wire<T> & source, Filter filter)
+{
+	using R = std::decay_t<decltype(filter.update(std::declval<T>(), ticks_t()))>;
+	struct State {
+		Wire<T> source;
+		Filter filter;
+		R value;
+		uint32_t epoch;
+		bool hasValue;
+	};
+	auto state = std::make_shared<State>(State { source, std::move(filter), R(), 0, false });
+	return Wire<R>(std::function<R()>([state] {
+		uint32_t epoch = Clock::epoch();
+		if (!state->hasValue || state->epoch != epoch) {
+			state->value = state->filter.update(state->source.getValue(), Clock::tick());
+			state->epoch = epoch;
+			state->hasValue = true;
+		}
+		return state->value;
+	}));
+}
+
+/**
+ * Подключает фильтр к датчику. В отличие от filterWire, фильтр получает только новые значения
+ * (см. SensorSamples::isNewSample) с временем их получения, поэтому медленный датчик не учитывается
+ * несколько раз, а производная и ограничение скорости считаются по реальным интервалам между значениями.
+ * @param sensor датчик
+ * @param filter фильтр
+ * @return провод с отфильтрованными значениями
+ */
+template<class Filter>
+auto filterSamples(const std::shared_ptr<Sensor> & sensor, Filter filter)
+{
+	using R = std::decay_t<decltype(filter.update(int(), ticks_t()))>;
+	struct State {
+		std::shared_ptr<SensorSamples> samples;
+		Filter filter;
+		R value;
+		uint32_t sequence;
+	};
+	auto state = std::make_shared<State>(State { SensorSamples::of(sensor), std::move(filter), R(), 0 });
+	return Wire<R>(std::function<R()>([state] {
+		// номер значения меняется только при новом значении, повторные чтения в том же такте его не меняют
+		const uint32_t sequence = state->samples->getSequence();
+		if (sequence != state->sequence) {
+			state->value = state->filter.update(state->samples->getSensor()->getValue(), state->samples->getTimestamp());
+			state->sequence = sequence;
+		}
+		return state->value;
+	}));
+}
+
+} /* namespace ev3 */
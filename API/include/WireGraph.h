@@ -0,0 +1,360 @@
+/*
+ * WireGraph.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include "Process.h"
+#include "Motor.h"
+#include "Sensor.h"
+#include "Wire.h"
+#include "InplaceFunction.h"
+
+#include <memory>
+#include <vector>
+
+namespace ev3 {
+
+/**
+ * Граф потоков данных, вычисляемый за один линейный проход.
+ * В отличие от проводов, которые вычисляются рекурсивно при каждом чтении, граф описывается
+ * декларативно (входы - датчики и провода, промежуточные узлы, выходы - моторы), затем
+ * сортируется топологически, а значения всех узлов хранятся в непрерывном массиве.
+ *
+ * Граф является процессом: на каждом такте update вычисляет все узлы по порядку,
+ * после чего EV3 вызывает updateOutputs и моторы получают новые значения.
+ * Процесс не завершается сам, его следует объединять с условием завершения:
+ *   eva->runProcess(graph & WaitTimeProcess(1.0f));
+ * Если граф не удалось построить (цикл или ссылка на несуществующий узел), процесс завершается
+ * на первом такте, а isFailed возвращает true. Повторно граф строится только после его изменения.
+ *
+ * Граф должен существовать, пока моторы, подключенные к его выходам, используют эти значения.
+ */
+class WireGraph : public virtual Process {
+public:
+	typedef int NodeId;
+
+	/**
+	 * Операция узла
+	 */
+	enum class Operation : uint8_t {
+		INPUT,    //!< значение на входном проводе
+		CONSTANT, //!< постоянное значение
+		ADD,      //!< a + b
+		SUB,      //!< a - b
+		MUL,      //!< a * b
+		DIV,      //!< a / b
+		MIN,      //!< min(a, b)
+		MAX,      //!< max(a, b)
+		FUNCTION, //!< произвольная функция f(a, b)
+	};
+
+	static constexpr NodeId NO_NODE = -1;
+
+	WireGraph() = default;
+	virtual ~WireGraph() = default;
+
+	/**
+	 * Добавляет вход - провод
+	 * @param wire провод
+	 * @return идентификатор узла
+	 */
+	NodeId addInput(const WireF & wire) {
+		NodeId node = addNode(Operation::INPUT, NO_NODE, NO_NODE);
+		nodeInputs[node] = (int)inputs.size();
+		inputs.push_back(wire);
+		return node;
+	}
+
+	/**
+	 * Добавляет вход - значение датчика
+	 * @param sensor датчик
+	 * @return идентификатор узла
+	 */
+	NodeId addInput(const SensorPtr & sensor) {
+		return addInput(WireF(sensor->getValueWire()));
+	}
+
+	/**
+	 * Добавляет постоянное значение
+	 * @param value значение
+	 * @return идентификатор узла
+	 */
+	NodeId addConstant(float value) {
+		NodeId node = addNode(Operation::CONSTANT, NO_NODE, NO_NODE);
+		constants[node] = value;
+		return node;
+	}
+
+	/**
+	 * Добавляет промежуточный узел. Входы могут ссылаться на любые узлы, в том числе добавленные позже
+	 * (см. setInputs) - порядок вычисления определяется в compile.
+	 * @param operation операция
+	 * @param a первый аргумент
+	 * @param b второй аргумент
+	 * @return идентификатор узла
+	 */
+	NodeId addNode(Operation operation, NodeId a, NodeId b) {
+		NodeId node = (NodeId)operations.size();
+		operations.push_back(operation);
+		firstArguments.push_back(a);
+		secondArguments.push_back(b);
+		nodeInputs.push_back(-1);
+		constants.push_back(0.0f);
+		functions.push_back(-1);
+		compiled = false;
+		failed = false;
+		return node;
+	}
+
+	/**
+	 * Добавляет узел с произвольной функцией двух аргументов
+	 * @param function функция
+	 * @param a первый аргумент
+	 * @param b второй аргумент (может быть NO_NODE, тогда в функцию передаётся 0)
+	 * @return идентификатор узла
+	 */
+	NodeId addFunction(InplaceFunction<float(float, float)> function, NodeId a, NodeId b = NO_NODE) {
+		NodeId node = addNode(Operation::FUNCTION, a, b);
+		functions[node] = (int)userFunctions.size();
+		userFunctions.push_back(std::move(function));
+		return node;
+	}
+
+	NodeId add(NodeId a, NodeId b) { return addNode(Operation::ADD, a, b); }
+	NodeId sub(NodeId a, NodeId b) { return addNode(Operation::SUB, a, b); }
+	NodeId mul(NodeId a, NodeId b) { return addNode(Operation::MUL, a, b); }
+	NodeId div(NodeId a, NodeId b) { return addNode(Operation::DIV, a, b); }
+	NodeId min(NodeId a, NodeId b) { return addNode(Operation::MIN, a, b); }
+	NodeId max(NodeId a, NodeId b) { return addNode(Operation::MAX, a, b); }
+
+	/**
+	 * Переназначает аргументы узла
+	 * @param node узел
+	 * @param a первый аргумент
+	 * @param b второй аргумент
+	 */
+	void setInputs(NodeId node, NodeId a, NodeId b) {
+		firstArguments[node] = a;
+		secondArguments[node] = b;
+		compiled = false;
+		failed = false;
+	}
+
+	/**
+	 * Подключает мотор к выходу графа. Мощность мотора будет равна значению узла.
+	 * @param motor мотор
+	 * @param node узел
+	 */
+	void addOutput(const MotorPtr & motor, NodeId node) {
+		outputMotors.push_back(motor);
+		outputNodes.push_back(node);
+		compiled = false;
+		failed = false;
+	}
+
+	/**
+	 * Топологическая сортировка узлов и построение плана вычисления.
+	 * Вызывается автоматически на первом такте.
+	 * @return false, если в графе есть цикл или ссылка на несуществующий узел
+	 */
+	bool compile() {
+		const int count = (int)operations.size();
+		// алгоритм Кана: узлы без невычисленных аргументов идут первыми
+		std::vector<int> numberOfArguments(count, 0);
+		std::vector<std::vector<NodeId>> dependents(count);
+		for (NodeId node = 0; node < count; ++node) {
+			for (NodeId argument : { firstArguments[node], secondArguments[node] }) {
+				if (argument == NO_NODE) {
+					continue;
+				}
+				if (argument < 0 || argument >= count) {
+					return false;
+				}
+				numberOfArguments[node]++;
+				dependents[argument].push_back(node);
+			}
+		}
+		for (NodeId node : outputNodes) {
+			if (node < 0 || node >= count) {
+				return false;
+			}
+		}
+		std::vector<NodeId> order;
+		order.reserve(count);
+		for (NodeId node = 0; node < count; ++node) {
+			if (numberOfArguments[node] == 0) {
+				order.push_back(node);
+			}
+		}
+		for (size_t i = 0; i < order.size(); ++i) {
+			for (NodeId dependent : dependents[order[i]]) {
+				if (--numberOfArguments[dependent] == 0) {
+					order.push_back(dependent);
+				}
+			}
+		}
+		if ((int)order.size() != count) {
+			return false;
+		}
+
+		slots.assign(count, 0);
+		for (int slot = 0; slot < count; ++slot) {
+			slots[order[slot]] = slot;
+		}
+		auto slotOf = [this](NodeId node) { return node == NO_NODE ? NO_NODE : slots[node]; };
+		scheduleOperations.resize(count);
+		scheduleFirst.resize(count);
+		scheduleSecond.resize(count);
+		scheduleData.resize(count);
+		for (int slot = 0; slot < count; ++slot) {
+			NodeId node = order[slot];
+			scheduleOperations[slot] = operations[node];
+			scheduleFirst[slot] = slotOf(firstArguments[node]);
+			scheduleSecond[slot] = slotOf(secondArguments[node]);
+			switch (operations[node]) {
+			case Operation::INPUT:
+				scheduleData[slot] = nodeInputs[node];
+				break;
+			case Operation::FUNCTION:
+				scheduleData[slot] = functions[node];
+				break;
+			default:
+				scheduleData[slot] = 0;
+				break;
+			}
+		}
+		values.assign(count, 0.0f);
+		for (NodeId node = 0; node < count; ++node) {
+			if (operations[node] == Operation::CONSTANT) {
+				values[slots[node]] = constants[node];
+			}
+		}
+
+		for (size_t i = 0; i < outputMotors.size(); ++i) {
+			int slot = slots[outputNodes[i]];
+			outputMotors[i]->setPower(WireI(std::function<int()>([this, slot] { return (int)values[slot]; })));
+		}
+		compiled = true;
+		return true;
+	}
+
+	/**
+	 * Вычисление всех узлов графа за один проход
+	 */
+	void evaluate() {
+		const int count = (int)scheduleOperations.size();
+		float *v = values.data();
+		for (int slot = 0; slot < count; ++slot) {
+			const int a = scheduleFirst[slot];
+			const int b = scheduleSecond[slot];
+			switch (scheduleOperations[slot]) {
+			case Operation::INPUT:
+				v[slot] = inputs[scheduleData[slot]].getValue();
+				break;
+			case Operation::CONSTANT:
+				break;
+			case Operation::ADD:
+				v[slot] = v[a] + v[b];
+				break;
+			case Operation::SUB:
+				v[slot] = v[a] - v[b];
+				break;
+			case Operation::MUL:
+				v[slot] = v[a] * v[b];
+				break;
+			case Operation::DIV:
+				v[slot] = v[a] / v[b];
+				break;
+			case Operation::MIN:
+				v[slot] = v[a] < v[b] ? v[a] : v[b];
+				break;
+			case Operation::MAX:
+				v[slot] = v[a] < v[b] ? v[b] : v[a];
+				break;
+			case Operation::FUNCTION:
+				v[slot] = userFunctions[scheduleData[slot]](v[a], b == NO_NODE ? 0.0f : v[b]);
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Значение узла, вычисленное на последнем такте
+	 * @param node узел
+	 * @return значение
+	 */
+	float getValue(NodeId node) const {
+		return values[slots[node]];
+	}
+
+	/**
+	 * Значение узла в виде провода. Провод читает значение, вычисленное на последнем такте.
+	 * @param node узел
+	 * @return провод
+	 */
+	WireF getWire(NodeId node) const {
+		return WireF(std::function<float()>([this, node] { return getValue(node); }));
+	}
+
+	/**
+	 * Количество узлов графа
+	 */
+	int getNumberOfNodes() const {
+		return (int)operations.size();
+	}
+
+	/**
+	 * Построить граф не удалось (см. compile)
+	 */
+	bool isFailed() const {
+		return failed;
+	}
+
+	virtual void update(time_t secondsFromStart) override {
+		Process::update(secondsFromStart);
+		if (failed) {
+			return;
+		}
+		if (!compiled && !compile()) {
+			failed = true;
+			return;
+		}
+		evaluate();
+	}
+
+	virtual bool isCompleted(time_t secondsFromStart) override {
+		return failed;
+	}
+
+protected:
+	bool compiled = false;
+	bool failed = false;
+
+	// описание графа (в порядке добавления)
+	std::vector<Operation> operations;
+	std::vector<NodeId> firstArguments;
+	std::vector<NodeId> secondArguments;
+	std::vector<int> nodeInputs;
+	std::vector<float> constants;
+	std::vector<int> functions;
+	std::vector<WireF> inputs;
+	std::vector<InplaceFunction<float(float, float)>> userFunctions;
+	std::vector<MotorPtr> outputMotors;
+	std::vector<NodeId> outputNodes;
+
+	// план вычисления (в топологическом порядке)
+	std::vector<int> slots;
+	std::vector<Operation> scheduleOperations;
+	std::vector<int> scheduleFirst;
+	std::vector<int> scheduleSecond;
+	std::vector<int> scheduleData;
+	std::vector<float> values;
+};
+
+typedef std::shared_ptr<WireGraph> WireGraphPtr;
+
+} /* namespace ev3 */
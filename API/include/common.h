@@ -1,5 +1,35 @@
 #pragma once
 
+#include <cstdint>
+
 namespace ev3 {
 typedef double time_t;
+
+/**
+ * Время в микросекундах (см. Clock). Целочисленная арифметика не требует
+ * программной эмуляции плавающей точки на блоке EV3.
+ */
+typedef int64_t ticks_t;
+
+const ticks_t TICKS_PER_SECOND = 1000000;
+const ticks_t TICKS_PER_MILLISECOND = 1000;
+
+/**
+ * Перевод из микросекунд в секунды. Используется для совместимости со старым интерфейсом,
+ * где время передаётся в секундах.
+ * @param ticks время в микросекундах
+ * @return время в секундах
+ */
+inline time_t ticksToSeconds(ticks_t ticks) {
+	return ticks / (time_t)TICKS_PER_SECOND;
+}
+
+/**
+ * Перевод из секунд в микросекунды
+ * @param seconds время в секундах
+ * @return время в микросекундах
+ */
+inline ticks_t secondsToTicks(time_t seconds) {
+	return (ticks_t)(seconds * TICKS_PER_SECOND);
+}
 }
@@ -36,6 +36,13 @@ public:
 		group.emplace_back(std::make_shared<ProcessClass>(process));
 	}
 
+	/**
+	 * Процессы группы
+	 */
+	const std::vector<std::shared_ptr<Process>>& getProcesses() const {
+		return group;
+	}
+
 protected:
 	std::vector<std::shared_ptr<Process>> group;
 	bool completeIfAnyIsCompleted;
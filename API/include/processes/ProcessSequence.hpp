@@ -43,6 +43,13 @@ public:
 		sequence.emplace(std::move(process));
 	}
 
+	/**
+	 * Процессы, которые ещё не завершены, в порядке выполнения
+	 */
+	const std::queue<std::shared_ptr<Process>>& getProcesses() const {
+		return sequence;
+	}
+
 protected:
 	std::queue<std::shared_ptr<Process>> sequence;
 };
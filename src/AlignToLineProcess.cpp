@@ -0,0 +1,107 @@
+#include "AlignToLineProcess.h"
+
+#include <cmath>
+
+// провод не должен ссылаться на процесс: процессы копируются при объединении в группы
+static ev3::WireF alignErrorWire(const ev3::SensorPtr &leftLight, const ev3::SensorPtr &rightLight) {
+	return ev3::WireF([leftLight, rightLight] { return (float)(rightLight->getValue() - leftLight->getValue()); });
+}
+
+AlignToLineProcess::AlignToLineProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight,
+		std::shared_ptr<AlignToLineStatistics> statistics)
+: leftMotor(std::move(leftMotor))
+, rightMotor(std::move(rightMotor))
+, leftLight(std::move(leftLight))
+, rightLight(std::move(rightLight))
+, pd(std::make_shared<ev3::PID>(0.5f, 0.0f, 1.0f))
+, statistics(std::move(statistics))
+, errorThreshold(5)
+, rateThreshold(100)
+, settleTicks(5)
+, timeout(0.5f)
+, startTime(0)
+, prevTime(0)
+, prevError(0)
+, numberOfSettledTicks(0)
+, completed(false)
+{
+	pd->setError(alignErrorWire(this->leftLight, this->rightLight));
+}
+
+void AlignToLineProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (completed) {
+		return;
+	}
+
+	float error = getError();
+	pd->update(secondsFromStart);
+	int turn = (int)pd->getPower();
+	rightMotor->setPower(turn);
+	leftMotor->setPower(-turn);
+
+	ev3::time_t dt = secondsFromStart - prevTime;
+	float rate = dt > 0 ? (error - prevError) / dt : 0.0f;
+	prevError = error;
+	prevTime = secondsFromStart;
+
+	if (std::fabs(error) < errorThreshold && std::fabs(rate) < rateThreshold) {
+		numberOfSettledTicks++;
+	} else {
+		numberOfSettledTicks = 0;
+	}
+
+	if (numberOfSettledTicks >= settleTicks) {
+		complete(secondsFromStart, false);
+	} else if (secondsFromStart - startTime >= timeout) {
+		complete(secondsFromStart, true);
+	}
+}
+
+void AlignToLineProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	pd->reset();
+	startTime = secondsFromStart;
+	prevTime = secondsFromStart;
+	prevError = getError();
+	numberOfSettledTicks = 0;
+	completed = false;
+}
+
+bool AlignToLineProcess::isCompleted(ev3::time_t) {
+	return completed;
+}
+
+void AlignToLineProcess::setSettleCriterion(float errorThreshold, float rateThreshold, int settleTicks) {
+	this->errorThreshold = errorThreshold;
+	this->rateThreshold = rateThreshold;
+	this->settleTicks = settleTicks;
+}
+
+void AlignToLineProcess::setTimeout(ev3::time_t timeout) {
+	this->timeout = timeout;
+}
+
+void AlignToLineProcess::setPID(std::shared_ptr<ev3::PID> pid) {
+	pd = std::move(pid);
+	pd->setError(alignErrorWire(leftLight, rightLight));
+}
+
+float AlignToLineProcess::getError() const {
+	return rightLight->getValue() - leftLight->getValue();
+}
+
+void AlignToLineProcess::complete(ev3::time_t secondsFromStart, bool timedOut) {
+	completed = true;
+	if (statistics) {
+		ev3::time_t alignTime = secondsFromStart - startTime;
+		statistics->numberOfAlignments++;
+		statistics->totalTime += alignTime;
+		if (alignTime > statistics->maxTime) {
+			statistics->maxTime = alignTime;
+		}
+		if (timedOut) {
+			statistics->numberOfTimeouts++;
+		}
+	}
+}
@@ -0,0 +1,89 @@
+/*
+ * AlignToLineProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+#include <Sensor.h>
+#include <PID.h>
+
+#include <memory>
+
+/**
+ * Статистика времени выравнивания
+ */
+struct AlignToLineStatistics {
+	int numberOfAlignments = 0;
+	int numberOfTimeouts = 0;
+	ev3::time_t totalTime = 0;
+	ev3::time_t maxTime = 0;
+
+	ev3::time_t getMeanTime() const {
+		return numberOfAlignments == 0 ? 0 : totalTime / numberOfAlignments;
+	}
+};
+
+/**
+ * Выравнивание робота на линии поворотом на месте.
+ * Ошибка - разность показаний датчиков right - left, поворот задаёт ПД-регулятор.
+ * Пороги по умолчанию рассчитаны на датчики отражённого света с шкалой 0..100.
+ * Процесс завершается, как только ошибка и скорость её изменения остаются меньше порогов
+ * в течение settleTicks тактов подряд, или по истечении timeout.
+ */
+class AlignToLineProcess : public virtual ev3::Process {
+public:
+	AlignToLineProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight,
+			std::shared_ptr<AlignToLineStatistics> statistics = nullptr);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	/**
+	 * Установить условие завершения
+	 * @param errorThreshold допустимая ошибка, по умолчанию 5
+	 * @param rateThreshold допустимая скорость изменения ошибки в единицах в секунду, по умолчанию 100
+	 * @param settleTicks количество тактов подряд, на которых должны выполняться условия, по умолчанию 5
+	 */
+	void setSettleCriterion(float errorThreshold, float rateThreshold, int settleTicks);
+
+	/**
+	 * Установить максимальное время выравнивания
+	 * @param timeout время в секундах, по умолчанию 0.5
+	 */
+	void setTimeout(ev3::time_t timeout);
+
+	/**
+	 * Установить коэффициенты ПД-регулятора
+	 * Значения по умолчанию: 0.5f, 0, 1.0f
+	 */
+	void setPID(std::shared_ptr<ev3::PID> pid);
+
+protected:
+	ev3::MotorPtr leftMotor;
+	ev3::MotorPtr rightMotor;
+	ev3::SensorPtr leftLight;
+	ev3::SensorPtr rightLight;
+	std::shared_ptr<ev3::PID> pd;
+	std::shared_ptr<AlignToLineStatistics> statistics;
+
+	float errorThreshold;
+	float rateThreshold;
+	int settleTicks;
+	ev3::time_t timeout;
+
+	ev3::time_t startTime;
+	ev3::time_t prevTime;
+	float prevError;
+	int numberOfSettledTicks;
+	bool completed;
+
+private:
+	float getError() const;
+	void complete(ev3::time_t secondsFromStart, bool timedOut);
+};
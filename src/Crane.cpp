@@ -1,38 +1,76 @@
 #include "Crane.h"
 
 #include <processes.h>
+#include <MotorArbiter.h>
+#include <MotorDynamics.h>
+
+#include "ProfiledMoveProcess.h"
+
+#include <algorithm>
 
 const int FULL_RANGE = 6400;
+const int FREE_TO_MOVE = 1300;
+// время сверх профиля до прерывания; по модели мотора кран доходит до цели через 0.1 с после конца профиля
+const ev3::time_t TIMEOUT_MARGIN = 0.5f;
 
 Crane::Crane(std::shared_ptr<ev3::Motor> motor)
 : motor(std::move(motor))
-, pid(std::make_shared<ev3::PID>(1.0f, 0.00001f, 2.0f))
+, limits({ 0.0f, 0.0f, 0.0f })
 {
 }
 
 std::shared_ptr<ev3::Process> Crane::up() {
-	pid->reset();
-	auto moveProcess = std::make_shared<ev3::MoveToEncoderAndStopProcess>(motor, -FULL_RANGE, 100, pid);
-	moveProcess->setEncoderThreshold(10);
-	moveProcess->setPowerThreshold(5);
-	return (moveProcess
-			& std::make_shared<ev3::WaitTimeProcess>(7.0f)) >> ev3::StopProcess(motor);
+	return moveTo(-FULL_RANGE);
 }
 
 std::shared_ptr<ev3::Process> Crane::down() {
-	pid->reset();
-	auto moveProcess = std::make_shared<ev3::MoveToEncoderAndStopProcess>(motor, 0, 100, pid);
-	moveProcess->setEncoderThreshold(10);
-	moveProcess->setPowerThreshold(5);
-	return (moveProcess
-			& std::make_shared<ev3::WaitTimeProcess>(7.0f)) >> ev3::StopProcess(motor);
+	return moveTo(0);
 }
 
 std::shared_ptr<ev3::Process> Crane::freeToMove() {
-	pid->reset();
-	auto moveProcess = std::make_shared<ev3::MoveToEncoderAndStopProcess>(motor, -1300, 100, pid);
+	return moveTo(-FREE_TO_MOVE);
+}
+
+ev3::time_t Crane::estimateUp() const {
+	return estimate(-FULL_RANGE);
+}
+
+ev3::time_t Crane::estimateDown() const {
+	return estimate(0);
+}
+
+ev3::time_t Crane::estimateFreeToMove() const {
+	return estimate(-FREE_TO_MOVE);
+}
+
+void Crane::setLimits(const ev3::MotionProfile::Limits &limits) {
+	this->limits = limits;
+}
+
+ev3::MotionProfile::Limits Crane::getMotorLimits() const {
+	// кран движется на полной мощности, как до профилей: скорость - установившаяся скорость мотора.
+	// Разгон за 2 * timeConstant: мотор первого порядка на полной мощности отстаёт от установившейся скорости
+	// на velocity * timeConstant, как и линейный разгон за это время, поэтому мотор не отстаёт от профиля
+	// и у регулятора остаётся запас по мощности на торможение
+	const std::shared_ptr<ev3::MotorDynamics> dynamics = ev3::MotorDynamics::of(motor);
+	const float velocity = dynamics->getFullPowerVelocity();
+	ev3::MotionProfile::Limits motorLimits = limits;
+	motorLimits.maxVelocity = limits.maxVelocity > 0 ? std::min(limits.maxVelocity, velocity) : velocity;
+	motorLimits.maxAcceleration = std::min(velocity / (2 * dynamics->getTimeConstant()), motor->getMaxAccelleration());
+	if (limits.maxAcceleration > 0) {
+		motorLimits.maxAcceleration = std::min(limits.maxAcceleration, motorLimits.maxAcceleration);
+	}
+	return motorLimits;
+}
+
+ev3::time_t Crane::estimate(int encoder) const {
+	return ev3::MotionProfile(encoder - motor->getEncoder(), getMotorLimits()).getDuration();
+}
+
+std::shared_ptr<ev3::Process> Crane::moveTo(int encoder) {
+	// завершение по положению; на упоре движение прерывается по ошибке слежения или по времени (см. ProfiledMoveProcess)
+	auto moveProcess = std::make_shared<ProfiledMoveProcess>(motor, encoder, getMotorLimits());
 	moveProcess->setEncoderThreshold(10);
-	moveProcess->setPowerThreshold(5);
-	return (moveProcess
-			& std::make_shared<ev3::WaitTimeProcess>(7.0f)) >> ev3::StopProcess(motor);
+	moveProcess->setTimeoutMargin(TIMEOUT_MARGIN);
+	return ev3::claimMotors(moveProcess >> ev3::StopProcess(motor), { motor });
 }
@@ -2,7 +2,7 @@
 
 #include <Motor.h>
 #include <Process.h>
-#include <PID.h>
+#include <MotionProfile.h>
 
 #include <memory>
 
@@ -15,7 +15,30 @@ public:
 	std::shared_ptr<ev3::Process> down();
 	std::shared_ptr<ev3::Process> freeToMove();
 
+	/**
+	 * Оценка времени движения крана из текущего положения (см. up, down, freeToMove)
+	 * @return время в секундах
+	 */
+	ev3::time_t estimateUp() const;
+	ev3::time_t estimateDown() const;
+	ev3::time_t estimateFreeToMove() const;
+
+	/**
+	 * Установить ограничения скорости, ускорения и рывка крана. По умолчанию (значения 0) кран движется
+	 * с возможностями мотора по его модели (см. getMotorLimits)
+	 */
+	void setLimits(const ev3::MotionProfile::Limits &limits);
+
 private:
+	std::shared_ptr<ev3::Process> moveTo(int encoder);
+
+	/**
+	 * Ограничения по модели мотора (см. MotorDynamics): скорость профиля - установившаяся скорость
+	 * на полной мощности, разгон до неё за две постоянные времени мотора
+	 */
+	ev3::MotionProfile::Limits getMotorLimits() const;
+	ev3::time_t estimate(int encoder) const;
+
 	std::shared_ptr<ev3::Motor> motor;
-	std::shared_ptr<ev3::PID> pid;
+	ev3::MotionProfile::Limits limits;
 };
@@ -0,0 +1,47 @@
+/*
+ * CrossTrace.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <CrossDetector.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Прогон записанных показаний через CrossDetector. Не зависит от EV3, поэтому используется
+ * и на блоке (debugReplayCrossTraces), и в проверке на компьютере (test/CrossDetectorReplay.cpp).
+ * Каждая строка файла: левый энкодер, левый датчик, правый энкодер, правый датчик
+ * (см. debugRecordCrossTraces).
+ * @param filename файл с записью
+ * @param meanThreshold пороговое среднее значение яркости в окне
+ * @return расстояние в градусах левого энкодера от начала записи до найденного перекрёстка или -1
+ */
+inline int replayCrossTrace(const char *filename, int meanThreshold) {
+	FILE* fIn = fopen(filename, "r");
+	if (fIn == nullptr) {
+		return -1;
+	}
+	ev3::CrossDetector<> detector(meanThreshold);
+	int leftEncoder, leftValue, rightEncoder, rightValue;
+	int startEncoder = 0;
+	bool started = false;
+	int result = -1;
+	while (fscanf(fIn, "%d %d %d %d", &leftEncoder, &leftValue, &rightEncoder, &rightValue) == 4) {
+		if (!started) {
+			detector.reset(leftEncoder, rightEncoder);
+			startEncoder = leftEncoder;
+			started = true;
+		}
+		if (detector.update(leftEncoder, leftValue, rightEncoder, rightValue)) {
+			result = std::abs(leftEncoder - startEncoder);
+			break;
+		}
+	}
+	fclose(fIn);
+	return result;
+}
@@ -1,6 +1,18 @@
 #include "DebugFunctions.h"
 
 #include <processes.h>
+#include <WireExpression.h>
+#include <CrossDetector.h>
+#include <ColorLookupTable.h>
+#include <SensorMemory.h>
+#include <MotorDynamics.h>
+
+#include "MotorIdentificationProcess.h"
+#include "CrossTrace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
 
 void debugGrabber(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Grabber> grabber) {
 	eva->runProcess(grabber->initialize() >> grabber->halfOpen());
@@ -24,6 +36,12 @@ void debugRotations(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move) {
 	eva->runProcess(move->rotateToLineRight(100, false));
 	eva->runProcess(move->rotateToLineRight(100, true));
 	eva->wait(1);
+
+	const AlignToLineStatistics& statistics = move->getAlignStatistics();
+	eva->lcdClean();
+	eva->lcdPrintf(ev3::Color::BLACK, "align %d, timeouts %d\n", statistics.numberOfAlignments, statistics.numberOfTimeouts);
+	eva->lcdPrintf(ev3::Color::BLACK, "mean %.3f max %.3f\n", statistics.getMeanTime(), statistics.maxTime);
+	eva->wait(5);
 }
 
 void debugColors(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<ev3::ColorSensor> colorSensor, std::vector<int> colors) {
@@ -35,3 +53,337 @@ void debugColors(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<ev3::ColorSensor
 		eva->wait(2);
 	}
 }
+
+void debugWireBenchmark(std::shared_ptr<ev3::EV3> eva) {
+	const int iterations = 10000;
+	int source = 0;
+	ev3::WireI left([&source] { return source; });
+	ev3::WireI right([&source] { return 1024 - source; });
+
+	// выражение глубины 8 в двух вариантах: через операторы Wire и через WireExpression
+	ev3::WireI wire = ((left - right) * 3 + (right - left) / 2) * ((left + right) - (left * 2 - right)) + 1;
+	ev3::WireI expression = ((ev3::wireExpr(left) - right) * 3 + (ev3::wireExpr(right) - left) / 2)
+			* ((ev3::wireExpr(left) + right) - (ev3::wireExpr(left) * 2 - right)) + 1;
+
+	int checksum = 0;
+	ev3::ticks_t start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		source = i & 1023;
+		checksum += wire.getValue();
+	}
+	ev3::ticks_t wireTicks = eva->readTicks() - start;
+
+	start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		source = i & 1023;
+		checksum -= expression.getValue();
+	}
+	ev3::ticks_t expressionTicks = eva->readTicks() - start;
+
+	eva->lcdClean();
+	eva->lcdPrintf(ev3::Color::BLACK, "wire %d us\n", (int)wireTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "expr %d us\n", (int)expressionTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "check %d\n", checksum);
+	eva->wait(5);
+}
+
+/**
+ * Количество выделений памяти при построении и вычислении выражения глубины 8 через операторы Wire
+ * и через WireExpression. Операторы Wire создают std::function на каждый узел, WireExpression -
+ * только при превращении в провод.
+ */
+void debugSensorMemoryBenchmark(std::shared_ptr<ev3::EV3> eva, const std::vector<ev3::SensorPtr> &sensors) {
+	const int iterations = 10000;
+	ev3::SensorMemory memory;
+	if (!memory.map()) {
+		eva->lcdClean();
+		eva->lcdPrintf(ev3::Color::BLACK, "map failed\n");
+		eva->wait(5);
+		return;
+	}
+	for (const auto &sensor : sensors) {
+		memory.setMode((int)sensor->getPort(), sensor->getMode());
+	}
+
+	int checksum = 0;
+	ev3::ticks_t start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		for (const auto &sensor : sensors) {
+			checksum += ReadSensor((int)sensor->getPort());
+		}
+	}
+	ev3::ticks_t readSensorTicks = eva->readTicks() - start;
+
+	int numberOfUpdates = 0;
+	start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		numberOfUpdates += __builtin_popcount(memory.update());
+		for (const auto &sensor : sensors) {
+			checksum -= memory.getValue((int)sensor->getPort());
+		}
+	}
+	ev3::ticks_t memoryTicks = eva->readTicks() - start;
+
+	eva->lcdClean();
+	eva->lcdPrintf(ev3::Color::BLACK, "read %d us\n", (int)readSensorTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "mmap %d us\n", (int)memoryTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "updates %d\n", numberOfUpdates);
+	eva->lcdPrintf(ev3::Color::BLACK, "check %d\n", checksum);
+	eva->wait(5);
+}
+
+void debugColorLookupBenchmark(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<ev3::ColorSensor> colorSensor, const std::vector<int> &colors) {
+	const int iterations = 10000;
+
+	ev3::ticks_t start = eva->readTicks();
+	ev3::ColorLookupTable<> table(colors);
+	ev3::ticks_t buildTicks = eva->readTicks() - start;
+
+	// преобразование и классификация без датчика по значениям из всего куба RGB
+	int checksum = 0;
+	start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		ev3::RGB rgb((unsigned char)(i * 7), (unsigned char)(i * 13), (unsigned char)(i * 29));
+		checksum += ev3::rgbToHsv(rgb).h;
+	}
+	ev3::ticks_t hsvTicks = eva->readTicks() - start;
+
+	start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		ev3::RGB rgb((unsigned char)(i * 7), (unsigned char)(i * 13), (unsigned char)(i * 29));
+		checksum -= ev3::rgbToHsvInt(rgb).h;
+	}
+	ev3::ticks_t hsvIntTicks = eva->readTicks() - start;
+
+	start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		ev3::RGB rgb((unsigned char)(i * 7), (unsigned char)(i * 13), (unsigned char)(i * 29));
+		checksum += table.getColorIndex(rgb);
+	}
+	ev3::ticks_t lookupTicks = eva->readTicks() - start;
+
+	// текущий путь на датчике и согласие таблицы с ним
+	int numberOfMismatches = 0;
+	start = eva->readTicks();
+	for (int i = 0; i < iterations; ++i) {
+		checksum += colorSensor->getColorIndex(colors);
+	}
+	ev3::ticks_t sensorTicks = eva->readTicks() - start;
+	for (int i = 0; i < iterations; ++i) {
+		if (table.getColorIndex(colorSensor->getRGBColor()) != colorSensor->getColorIndex(colors)) {
+			numberOfMismatches++;
+		}
+	}
+
+	eva->lcdClean();
+	eva->lcdPrintf(ev3::Color::BLACK, "build %d us\n", (int)buildTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "hsv %d us\n", (int)hsvTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "hsv int %d us\n", (int)hsvIntTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "lut %d us\n", (int)lookupTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "sensor %d us\n", (int)sensorTicks);
+	eva->lcdPrintf(ev3::Color::BLACK, "mismatch %d\n", numberOfMismatches);
+	eva->lcdPrintf(ev3::Color::BLACK, "check %d\n", checksum);
+	eva->wait(5);
+}
+
+static const int CROSS_TRACE_POWERS[] = { 50, 70, 100 };
+
+static std::string crossTraceName(int power) {
+	return "/home/root/lms2012/prjs/robofinist2023/cross" + std::to_string(power) + ".txt";
+}
+
+/**
+ * Запись показаний датчиков линии и энкодеров при проезде перекрёстка на мощностях 50, 70 и 100.
+ * Перед запуском робот ставится на линию примерно за 20 см до перекрёстка.
+ * Каждая строка файла: левый энкодер, левый датчик, правый энкодер, правый датчик.
+ */
+void debugRecordCrossTraces(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight) {
+	const int previousPower = move->getPower();
+	for (int power : CROSS_TRACE_POWERS) {
+		FILE* fOut = fopen(crossTraceName(power).c_str(), "w");
+		if (fOut == nullptr) {
+			eva->lcdClean();
+			eva->lcdPrintf(ev3::Color::BLACK, "can't write %d\n", power);
+			eva->wait(5);
+			break;
+		}
+		move->setPower(power);
+		eva->runProcess(move->moveOnLine(800, true) & ev3::LambdaProcess([&](float timestamp) {
+			fprintf(fOut, "%d %d %d %d\n", leftMotor->getEncoder(), leftLight->getValue(), rightMotor->getEncoder(), rightLight->getValue());
+			return true;
+		}));
+		fclose(fOut);
+
+		eva->lcdClean();
+		eva->lcdPrintf(ev3::Color::BLACK, "recorded %d\nback to start\n", power);
+		eva->wait(10);
+	}
+	move->setPower(previousPower);
+}
+
+/**
+ * Сравнение места срабатывания на записях с разными мощностями.
+ * При выборке по расстоянию перекрёсток должен находиться в одном и том же месте (с точностью до длины такта).
+ */
+void debugReplayCrossTraces(std::shared_ptr<ev3::EV3> eva) {
+	eva->lcdClean();
+	for (int power : CROSS_TRACE_POWERS) {
+		int distance = replayCrossTrace(crossTraceName(power).c_str(), 10);
+		eva->lcdPrintf(ev3::Color::BLACK, "%d: cross at %d\n", power, distance);
+	}
+	eva->wait(10);
+}
+
+/**
+ * Измерение расстояния между соседними перекрёстками (длины ребра) для moveOnLineToCross(int, int, bool).
+ * Робот ставится на линию перед перекрёстком, за которым идут ещё EDGE_MEASURE_EDGES рёбер.
+ * Перекрёстки ищутся обычным moveOnLineToCross без ожидаемого расстояния, длина ребра - среднее
+ * по энкодерам между соседними перекрёстками. Результат сохраняется в edge.txt.
+ */
+void debugMeasureEdgeLength(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor) {
+	const int EDGE_MEASURE_EDGES = 3;
+	std::vector<int> crosses;
+	auto recordCross = [&]() {
+		return ev3::LambdaProcess([&](float timestamp) {
+			crosses.push_back((leftMotor->getEncoder() + rightMotor->getEncoder()) / 2);
+			return false;
+		});
+	};
+	std::shared_ptr<ev3::Process> process = move->moveOnLineToCross(0, false) >> recordCross();
+	for (int i = 0; i < EDGE_MEASURE_EDGES; ++i) {
+		process = process >> move->moveOnLineToCross(0, i == EDGE_MEASURE_EDGES - 1) >> recordCross();
+	}
+	eva->runProcess(process);
+
+	eva->lcdClean();
+	if (crosses.size() != EDGE_MEASURE_EDGES + 1) {
+		eva->lcdPrintf(ev3::Color::BLACK, "measure failed\n");
+		eva->wait(5);
+		return;
+	}
+	int edgeLength = (crosses.back() - crosses.front()) / EDGE_MEASURE_EDGES;
+	for (size_t i = 1; i < crosses.size(); ++i) {
+		eva->lcdPrintf(ev3::Color::BLACK, "edge %d: %d\n", (int)i, crosses[i] - crosses[i - 1]);
+	}
+	FILE* fOut = fopen("/home/root/lms2012/prjs/robofinist2023/edge.txt", "w");
+	if (fOut == nullptr) {
+		eva->lcdPrintf(ev3::Color::BLACK, "can't write edge.txt\n");
+	} else {
+		fprintf(fOut, "%d\n", edgeLength);
+		fclose(fOut);
+		eva->lcdPrintf(ev3::Color::BLACK, "edge length %d\n", edgeLength);
+	}
+	eva->wait(10);
+}
+
+/**
+ * Калибровка оценки положения линии. Перед запуском робот ставится ровно на линию.
+ * Таблица сохраняется в line.txt и загружается при следующем запуске.
+ */
+void debugCalibrateLinePosition(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, std::shared_ptr<LinePosition> linePosition) {
+	eva->runProcess(move->calibrateLinePosition(linePosition));
+	eva->lcdClean();
+	if (linePosition->isCalibrated() && linePosition->save("/home/root/lms2012/prjs/robofinist2023/line.txt")) {
+		eva->lcdPrintf(ev3::Color::BLACK, "line calibrated\n");
+		move->setLinePosition(linePosition);
+	} else {
+		eva->lcdPrintf(ev3::Color::BLACK, "calibration failed\n");
+	}
+	eva->wait(5);
+}
+
+/**
+ * Измерение замедления для BrakingProfile: разгон до мощности power, сброс мощности
+ * и измерение пути до остановки.
+ */
+void debugMeasureDeceleration(std::shared_ptr<ev3::EV3> eva, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int power) {
+	// скорость в момент сброса мощности - по оценке скорости на последнем такте движения
+	float velocity = 0;
+	eva->runProcess(ev3::MoveByEncoderOnArcProcess(leftMotor, rightMotor, 600, 600, power) & ev3::LambdaProcess([&](float timestamp) {
+		velocity = (ev3::MotorDynamics::of(leftMotor)->getVelocity() + ev3::MotorDynamics::of(rightMotor)->getVelocity()) / 2;
+		return true;
+	}));
+	int encoder = leftMotor->getEncoder() + rightMotor->getEncoder();
+
+	leftMotor->setPower(0);
+	rightMotor->setPower(0);
+	eva->wait(1.0f);
+	float distance = (leftMotor->getEncoder() + rightMotor->getEncoder() - encoder) / 2.0f;
+
+	eva->lcdClean();
+	eva->lcdPrintf(ev3::Color::BLACK, "v %.0f d %.0f\n", velocity, distance);
+	eva->lcdPrintf(ev3::Color::BLACK, "a %.0f\n", ev3::BrakingProfile::measureDeceleration(velocity, distance));
+	eva->wait(10);
+}
+
+/**
+ * Сравнение остановки ПИД-регулятором и по кривой торможения: время движения и ошибка остановки.
+ * Результаты записываются в braking.txt: режим, расстояние, время в секундах, ошибка в градусах.
+ */
+void debugBraking(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor) {
+	const int distances[] = { 200, 500, 1000 };
+	FILE* fOut = fopen("/home/root/lms2012/prjs/robofinist2023/braking.txt", "w");
+	eva->lcdClean();
+	if (fOut == nullptr) {
+		eva->lcdPrintf(ev3::Color::BLACK, "can't write braking.txt\n");
+		eva->wait(5);
+		return;
+	}
+	for (auto mode : { Move::BrakingMode::PID, Move::BrakingMode::TIME_OPTIMAL }) {
+		move->setBrakingMode(mode);
+		for (int distance : distances) {
+			int encoderStart = leftMotor->getEncoder() + rightMotor->getEncoder();
+			ev3::ticks_t start = eva->readTicks();
+			eva->runProcess(move->moveByEncoder(distance, distance, true));
+			ev3::time_t time = ev3::ticksToSeconds(eva->readTicks() - start);
+			eva->wait(0.5f);
+			int error = (leftMotor->getEncoder() + rightMotor->getEncoder() - encoderStart) / 2 - distance;
+
+			const char *name = mode == Move::BrakingMode::PID ? "pid" : "optimal";
+			fprintf(fOut, "%s %d %.3f %d\n", name, distance, time, error);
+			eva->lcdPrintf(ev3::Color::BLACK, "%s %d: %.2f %d\n", name, distance, time, error);
+		}
+	}
+	fclose(fOut);
+	move->setBrakingMode(Move::BrakingMode::PID);
+	eva->wait(10);
+}
+
+/**
+ * Определение параметров моторов. Робот ставится на подставку, чтобы колёса вращались свободно,
+ * кран - в среднее положение. Захват проходит только мощность трогания и одну короткую ступеньку,
+ * так как его ход мал; мощность ступеньки должна быть больше мощности трогания, иначе модель не строится.
+ * Параметры записываются в motorX.txt и загружаются в setupMotors. Если параметры мотора не найдены,
+ * файл не перезаписывается, и мотор остаётся с прежней моделью.
+ */
+void debugIdentifyMotors(std::shared_ptr<ev3::EV3> eva, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::MotorPtr craneMotor, ev3::MotorPtr grabMotor) {
+	struct MotorToIdentify {
+		ev3::MotorPtr motor;
+		const char *name;
+		std::vector<int> powers;
+		ev3::time_t stepTime;
+	};
+	const MotorToIdentify motors[] = {
+		{ leftMotor, "B", { 30, 60, 90 }, 0.6f },
+		{ rightMotor, "A", { 30, 60, 90 }, 0.6f },
+		{ craneMotor, "C", { 30, 60, 90 }, 0.6f },
+		{ grabMotor, "D", { 40 }, 0.2f },
+	};
+	eva->lcdClean();
+	for (const auto &m : motors) {
+		auto identification = std::make_shared<MotorIdentificationProcess>(m.motor, m.powers, m.stepTime);
+		eva->runProcess(identification);
+		if (identification->isStartUpFailed()) {
+			eva->lcdPrintf(ev3::Color::BLACK, "%s: doesn't move\n", m.name);
+		} else if (!identification->isFitted()) {
+			eva->lcdPrintf(ev3::Color::BLACK, "%s: no fit, start %d\n", m.name, identification->getStartUpPower());
+		} else {
+			identification->apply();
+			bool saved = identification->save(("/home/root/lms2012/prjs/robofinist2023/motor" + std::string(m.name) + ".txt").c_str());
+			eva->lcdPrintf(ev3::Color::BLACK, "%s: %d %.0f %.3f%s\n", m.name, identification->getStartUpPower(),
+					identification->getSpeedOnMaxPower(), identification->getTimeConstant(), saved ? "" : " not saved");
+		}
+		eva->wait(1);
+	}
+	eva->wait(10);
+}
@@ -7,8 +7,19 @@
 #include "Move.h"
 #include "Crane.h"
 #include "Grabber.h"
+#include "LinePosition.h"
 
 void debugGrabber(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Grabber> grabber);
 void debugCrane(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Crane> crane);
 void debugRotations(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move);
+void debugWireBenchmark(std::shared_ptr<ev3::EV3> eva);
+void debugSensorMemoryBenchmark(std::shared_ptr<ev3::EV3> eva, const std::vector<ev3::SensorPtr> &sensors);
+void debugRecordCrossTraces(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight);
+void debugReplayCrossTraces(std::shared_ptr<ev3::EV3> eva);
+void debugMeasureEdgeLength(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor);
+void debugMeasureDeceleration(std::shared_ptr<ev3::EV3> eva, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int power);
+void debugBraking(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor);
+void debugIdentifyMotors(std::shared_ptr<ev3::EV3> eva, ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::MotorPtr craneMotor, ev3::MotorPtr grabMotor);
+void debugCalibrateLinePosition(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<Move> move, std::shared_ptr<LinePosition> linePosition);
+void debugColorLookupBenchmark(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<ev3::ColorSensor> colorSensor, const std::vector<int> &colors);
 void debugColors(std::shared_ptr<ev3::EV3> eva, std::shared_ptr<ev3::ColorSensor> colorSensor, std::vector<int> colors);
@@ -1,41 +1,52 @@
 #include "Grabber.h"
 
 #include "processes.h"
+#include "MotorArbiter.h"
+
+#include "StallProcess.h"
+
+// захват закрыт - энкодер 0 (см. initialize); если захват остановился дальше, в нём бочка
+const int BARREL_GRIP_ENCODER = 8;
 
 Grabber::Grabber(std::shared_ptr<ev3::Motor> motor)
-: motor(motor), pid(std::make_shared<ev3::PID>(0.3f, 0.001f, 1.2f)) {
+: motor(motor), pid(std::make_shared<ev3::PID>(0.3f, 0.001f, 1.2f)), barrelGripped(false) {
 
 }
 
 std::shared_ptr<ev3::Process> Grabber::initialize() {
-	return std::make_shared<ev3::StopProcess>(motor)
-			>> std::make_shared<ev3::SetPowerProcess>(motor, -50)
-			>> std::make_shared<ev3::WaitTimeProcess>(0.5f)
+	return ev3::claimMotors(std::make_shared<ev3::StopProcess>(motor)
+			>> std::make_shared<StallProcess>(motor, -50, 0)
 			>> std::make_shared<ev3::LambdaProcess>([&](ev3::time_t timestamp) {
 		motor->resetEncoder();
 		return false;
-	});
+	}), { motor });
 }
 
 std::shared_ptr<ev3::Process> Grabber::open() {
-	return std::make_shared<ev3::StopProcess>(motor)
-			>> std::make_shared<ev3::SetPowerProcess>(motor, 50)
-			>> std::make_shared<ev3::WaitTimeProcess>(0.5f)
-			>> std::make_shared<ev3::SetPowerProcess>(motor, 20)
-			>> std::make_shared<ev3::WaitTimeProcess>(0.2f)
-			;
+	return ev3::claimMotors(std::make_shared<ev3::StopProcess>(motor)
+			>> std::make_shared<StallProcess>(motor, 50, 20), { motor });
 }
 
 std::shared_ptr<ev3::Process> Grabber::halfOpen() {
 	auto moveProcess = std::make_shared<ev3::MoveToEncoderAndStopProcess>(motor, 20, 50, pid);
 	moveProcess->setPowerThreshold(2);
 	moveProcess->setEncoderThreshold(2);
-	return std::make_shared<ev3::StopProcess>(motor)
+	return ev3::claimMotors(std::make_shared<ev3::StopProcess>(motor)
 			>> (moveProcess & std::make_shared<ev3::WaitTimeProcess>(1.0f))
-			>> std::make_shared<ev3::StopProcess>(motor);
+			>> std::make_shared<ev3::StopProcess>(motor), { motor });
 }
 
 std::shared_ptr<ev3::Process> Grabber::close() {
-	return std::make_shared<ev3::StopProcess>(motor)
-			>> std::make_shared<ev3::SetPowerProcess>(motor, -50);
+	auto closeProcess = std::make_shared<StallProcess>(motor, -50, -20);
+	// результат записывается, когда захват закрылся, а не когда строится процесс
+	return ev3::claimMotors(std::make_shared<ev3::StopProcess>(motor)
+			>> closeProcess
+			>> std::make_shared<ev3::LambdaProcess>([this, closeProcess](ev3::time_t) {
+		barrelGripped = closeProcess->isStalled() && closeProcess->getStallEncoder() > BARREL_GRIP_ENCODER;
+		return false;
+	}), { motor });
+}
+
+bool Grabber::isBarrelGripped() const {
+	return barrelGripped;
 }
@@ -16,7 +16,14 @@ public:
 	std::shared_ptr<ev3::Process> halfOpen();
 	std::shared_ptr<ev3::Process> close();
 
+	/**
+	 * Бочка в захвате: при последнем выполненном закрытии (см. close) захват упёрся в бочку,
+	 * не дойдя до закрытого положения
+	 */
+	bool isBarrelGripped() const;
+
 private:
 	std::shared_ptr<ev3::Motor> motor;
 	std::shared_ptr<ev3::PID> pid;
+	bool barrelGripped;
 };
@@ -0,0 +1,115 @@
+#include "LinePosition.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+LinePosition::LinePosition(ev3::SensorPtr leftLight, ev3::SensorPtr rightLight)
+: leftLight(std::move(leftLight))
+, rightLight(std::move(rightLight))
+, calibrated(false)
+{
+	startCalibration();
+	for (int i = 0; i < TABLE_SIZE; ++i) {
+		table[i] = 0.0f;
+	}
+}
+
+void LinePosition::startCalibration() {
+	for (int i = 0; i < TABLE_SIZE; ++i) {
+		sums[i] = 0.0f;
+		counts[i] = 0;
+	}
+}
+
+void LinePosition::addCalibrationSample(float offset) {
+	int index = (int)std::lround((float)(getDifference() - MIN_DIFFERENCE) / DIFFERENCE_STEP);
+	index = std::max(0, std::min(TABLE_SIZE - 1, index));
+	sums[index] += offset;
+	counts[index]++;
+}
+
+bool LinePosition::finishCalibration() {
+	int first = -1;
+	int last = -1;
+	for (int i = 0; i < TABLE_SIZE; ++i) {
+		if (counts[i] > 0) {
+			table[i] = sums[i] / counts[i];
+			if (first < 0) {
+				first = i;
+			}
+			last = i;
+		}
+	}
+	if (first < 0 || first == last) {
+		return false;
+	}
+
+	// заполняем пропуски между узлами интерполяцией, за крайними узлами - крайним значением
+	for (int i = 0; i < first; ++i) {
+		table[i] = table[first];
+	}
+	for (int i = last + 1; i < TABLE_SIZE; ++i) {
+		table[i] = table[last];
+	}
+	int previous = first;
+	for (int i = first + 1; i <= last; ++i) {
+		if (counts[i] == 0) {
+			continue;
+		}
+		for (int j = previous + 1; j < i; ++j) {
+			table[j] = table[previous] + (table[i] - table[previous]) * (j - previous) / (i - previous);
+		}
+		previous = i;
+	}
+
+	// шум калибровки не должен делать зависимость немонотонной, иначе регулятор будет раскачиваться
+	bool increasing = table[last] >= table[first];
+	for (int i = 1; i < TABLE_SIZE; ++i) {
+		table[i] = increasing ? std::max(table[i], table[i - 1]) : std::min(table[i], table[i - 1]);
+	}
+	calibrated = true;
+	return true;
+}
+
+float LinePosition::getOffset() const {
+	float position = (float)(getDifference() - MIN_DIFFERENCE) / DIFFERENCE_STEP;
+	position = std::max(0.0f, std::min((float)(TABLE_SIZE - 1), position));
+	int index = std::min((int)position, TABLE_SIZE - 2);
+	float fraction = position - index;
+	return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+ev3::WireI LinePosition::getOffsetWire(float scale) const {
+	return ev3::WireI([this, scale] { return (int)std::lround(getOffset() * scale); });
+}
+
+bool LinePosition::save(const char *filename) const {
+	FILE* fOut = fopen(filename, "w");
+	if (fOut == nullptr) {
+		return false;
+	}
+	for (int i = 0; i < TABLE_SIZE; ++i) {
+		fprintf(fOut, "%f\n", table[i]);
+	}
+	fclose(fOut);
+	return true;
+}
+
+bool LinePosition::load(const char *filename) {
+	FILE* fIn = fopen(filename, "r");
+	if (fIn == nullptr) {
+		return false;
+	}
+	bool ok = true;
+	for (int i = 0; i < TABLE_SIZE && ok; ++i) {
+		ok = fscanf(fIn, "%f", &table[i]) == 1;
+	}
+	fclose(fIn);
+	calibrated = ok;
+	return ok;
+}
+
+int LinePosition::getDifference() const {
+	return rightLight->getValue() - leftLight->getValue();
+}
@@ -0,0 +1,76 @@
+/*
+ * LinePosition.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Sensor.h>
+#include <Wire.h>
+
+/**
+ * Оценка положения линии относительно робота по двум датчикам отражённого света.
+ * Разность показаний датчиков нелинейно зависит от смещения и насыщается, когда один из датчиков
+ * полностью съезжает с линии. Поэтому смещение в миллиметрах берётся из таблицы, построенной
+ * при калибровке: разность показаний -> смещение, с линейной интерполяцией между узлами.
+ *
+ * Смещение положительно, когда линия правее середины между датчиками.
+ */
+class LinePosition final {
+public:
+	LinePosition(ev3::SensorPtr leftLight, ev3::SensorPtr rightLight);
+	~LinePosition() = default;
+
+	/**
+	 * Начало калибровки: накопленные значения сбрасываются
+	 */
+	void startCalibration();
+
+	/**
+	 * Добавление калибровочного значения для текущих показаний датчиков
+	 * @param offset известное смещение линии в миллиметрах
+	 */
+	void addCalibrationSample(float offset);
+
+	/**
+	 * Построение таблицы по накопленным значениям. Пустые узлы заполняются интерполяцией,
+	 * таблица делается монотонной.
+	 * @return false, если значений недостаточно
+	 */
+	bool finishCalibration();
+
+	/**
+	 * Смещение линии в миллиметрах
+	 */
+	float getOffset() const;
+
+	/**
+	 * Смещение линии в виде провода
+	 * @param scale множитель, например 10 - смещение в десятых долях миллиметра
+	 */
+	ev3::WireI getOffsetWire(float scale) const;
+
+	bool isCalibrated() const {
+		return calibrated;
+	}
+
+	bool save(const char *filename) const;
+	bool load(const char *filename);
+
+private:
+	static const int TABLE_SIZE = 33;
+	static const int MIN_DIFFERENCE = -1024;
+	static const int DIFFERENCE_STEP = 64;
+
+	int getDifference() const;
+
+	ev3::SensorPtr leftLight;
+	ev3::SensorPtr rightLight;
+
+	float table[TABLE_SIZE];
+	float sums[TABLE_SIZE];
+	int counts[TABLE_SIZE];
+	bool calibrated;
+};
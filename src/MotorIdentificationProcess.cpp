@@ -0,0 +1,200 @@
+#include "MotorIdentificationProcess.h"
+
+#include <MotorDynamics.h>
+
+#include <cmath>
+#include <cstdio>
+
+// скорость, при которой мотор считается начавшим вращаться, градусов в секунду
+const float START_UP_VELOCITY = 30.0f;
+// мощность трогания увеличивается на 1 за это время
+const ev3::time_t START_UP_RAMP_TIME = 0.05f;
+const int MAX_START_UP_POWER = 30;
+// установившаяся скорость - среднее за последнюю часть ступеньки
+const float STEADY_PART = 0.3f;
+
+MotorIdentificationProcess::MotorIdentificationProcess(ev3::MotorPtr motor, std::vector<int> powers, ev3::time_t stepTime)
+: motor(std::move(motor))
+, powers(std::move(powers))
+, stepTime(stepTime)
+, phase(Phase::START_UP)
+, rampPower(0)
+, phaseStartTime(0)
+, stepIndex(0)
+, stepStartVelocity(0)
+, startUpPower(this->motor->getStartUpPower())
+, speedOnMaxPower(this->motor->getSpeedOnMaxPower())
+, timeConstant(ev3::MotorDynamics::of(this->motor)->getTimeConstant())
+, maxAcceleration(this->motor->getMaxAccelleration())
+, startUpFailed(false)
+, fitted(false)
+{
+}
+
+void MotorIdentificationProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	const float velocity = ev3::MotorDynamics::of(motor)->getVelocity();
+	const ev3::time_t t = secondsFromStart - phaseStartTime;
+
+	switch (phase) {
+	case Phase::START_UP:
+		if (std::fabs(velocity) <= START_UP_VELOCITY && rampPower >= MAX_START_UP_POWER) {
+			// мотор не вращается: мощность трогания не найдена, ступеньки не имеют смысла
+			startUpFailed = true;
+			motor->setPower(0);
+			phase = Phase::DONE;
+		} else if (std::fabs(velocity) > START_UP_VELOCITY) {
+			startUpPower = rampPower;
+			phase = Phase::STEPS;
+			phaseStartTime = secondsFromStart;
+			stepIndex = 0;
+			stepStartVelocity = velocity;
+			samples.clear();
+			motor->setPower(getStepPower(0));
+		} else if (t >= START_UP_RAMP_TIME) {
+			rampPower++;
+			phaseStartTime = secondsFromStart;
+			motor->setPower(rampPower);
+		}
+		break;
+
+	case Phase::STEPS:
+		samples.emplace_back(t, velocity);
+		if (t >= stepTime) {
+			finishStep();
+			stepIndex++;
+			if (stepIndex >= (int)powers.size() * 2) {
+				motor->setPower(0);
+				fit();
+				phase = Phase::DONE;
+			} else {
+				phaseStartTime = secondsFromStart;
+				stepStartVelocity = velocity;
+				samples.clear();
+				motor->setPower(getStepPower(stepIndex));
+			}
+		}
+		break;
+
+	case Phase::DONE:
+		break;
+	}
+}
+
+void MotorIdentificationProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	phase = Phase::START_UP;
+	phaseStartTime = secondsFromStart;
+	rampPower = 0;
+	startUpFailed = false;
+	fitted = false;
+	stepPowers.clear();
+	steadyVelocities.clear();
+	riseTimes.clear();
+	motor->setPower(0);
+}
+
+bool MotorIdentificationProcess::isCompleted(ev3::time_t) {
+	return phase == Phase::DONE;
+}
+
+int MotorIdentificationProcess::getStepPower(int index) const {
+	// каждая ступенька сначала вперёд, затем назад
+	const int power = powers[index / 2];
+	return index % 2 == 0 ? power : -power;
+}
+
+void MotorIdentificationProcess::finishStep() {
+	if (samples.empty()) {
+		return;
+	}
+	const int first = (int)(samples.size() * (1 - STEADY_PART));
+	float sum = 0;
+	for (size_t i = first; i < samples.size(); ++i) {
+		sum += samples[i].second;
+	}
+	const float steadyVelocity = sum / (samples.size() - first);
+
+	// время, за которое пройдено 63% изменения скорости
+	const float target = stepStartVelocity + 0.632f * (steadyVelocity - stepStartVelocity);
+	const bool increasing = steadyVelocity > stepStartVelocity;
+	ev3::time_t riseTime = samples.back().first;
+	for (const auto &sample : samples) {
+		if (increasing ? sample.second >= target : sample.second <= target) {
+			riseTime = sample.first;
+			break;
+		}
+	}
+
+	stepPowers.push_back(getStepPower(stepIndex));
+	steadyVelocities.push_back(steadyVelocity);
+	riseTimes.push_back(riseTime);
+}
+
+void MotorIdentificationProcess::fit() {
+	// v = k * (|power| - startUpPower), метод наименьших квадратов без свободного члена
+	float sumXY = 0;
+	float sumXX = 0;
+	float sumRiseTimes = 0;
+	int numberOfSteps = 0;
+	for (size_t i = 0; i < stepPowers.size(); ++i) {
+		const float x = std::abs(stepPowers[i]) - startUpPower;
+		if (x <= 0) {
+			continue;
+		}
+		sumXY += x * std::fabs(steadyVelocities[i]);
+		sumXX += x * x;
+		sumRiseTimes += riseTimes[i];
+		numberOfSteps++;
+	}
+	if (sumXX <= 0) {
+		return;
+	}
+	const float k = sumXY / sumXX;
+	speedOnMaxPower = k * 100;
+	timeConstant = sumRiseTimes / numberOfSteps;
+	// наибольшее ускорение - в начале разгона с места на полной мощности
+	maxAcceleration = timeConstant > 0 ? k * (100 - startUpPower) / timeConstant : maxAcceleration;
+	fitted = true;
+}
+
+void MotorIdentificationProcess::apply() const {
+	if (!fitted) {
+		return;
+	}
+	motor->setStartUpPower(startUpPower);
+	motor->setSpeedOnMaxPower(speedOnMaxPower);
+	ev3::MotorDynamics::of(motor)->setTimeConstant(timeConstant);
+	motor->setMaxAccelleration(maxAcceleration);
+}
+
+bool MotorIdentificationProcess::save(const char *filename) const {
+	if (!fitted) {
+		return false;
+	}
+	FILE* fOut = fopen(filename, "w");
+	if (fOut == nullptr) {
+		return false;
+	}
+	fprintf(fOut, "%d %f %f %f\n", startUpPower, speedOnMaxPower, timeConstant, maxAcceleration);
+	fclose(fOut);
+	return true;
+}
+
+bool MotorIdentificationProcess::loadMotorModel(const ev3::MotorPtr &motor, const char *filename) {
+	FILE* fIn = fopen(filename, "r");
+	if (fIn == nullptr) {
+		return false;
+	}
+	int startUpPower;
+	float speedOnMaxPower, timeConstant, maxAcceleration;
+	bool ok = fscanf(fIn, "%d %f %f %f", &startUpPower, &speedOnMaxPower, &timeConstant, &maxAcceleration) == 4;
+	fclose(fIn);
+	if (ok) {
+		motor->setStartUpPower(startUpPower);
+		motor->setSpeedOnMaxPower(speedOnMaxPower);
+		ev3::MotorDynamics::of(motor)->setTimeConstant(timeConstant);
+		motor->setMaxAccelleration(maxAcceleration);
+	}
+	return ok;
+}
@@ -0,0 +1,109 @@
+/*
+ * MotorIdentificationProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+
+#include <utility>
+#include <vector>
+
+/**
+ * Определение параметров модели мотора: мощность трогания, скорость на максимальной мощности
+ * и постоянная времени (см. MotorDynamics::getFeedforwardPower).
+ *
+ * Сначала мощность плавно увеличивается, пока мотор не начнёт вращаться - это мощность трогания.
+ * Затем на мотор подаются ступеньки мощности из списка, каждая сначала вперёд, потом назад,
+ * чтобы мотор с ограниченным ходом (кран) вернулся примерно в исходное положение.
+ * Установившаяся скорость на ступеньках даёт коэффициент усиления, время достижения 63%
+ * изменения скорости - постоянную времени.
+ *
+ * Если мотор не начал вращаться до мощности MAX_START_UP_POWER (мотор не подключен или упирается),
+ * идентификация прерывается. Ступеньки, мощность которых не больше мощности трогания, в расчёт
+ * не входят. Найденные параметры действительны, только если isFitted.
+ */
+class MotorIdentificationProcess : public virtual ev3::Process {
+public:
+	/**
+	 * @param motor мотор
+	 * @param powers мощности ступенек
+	 * @param stepTime длительность одной ступеньки в секундах
+	 */
+	MotorIdentificationProcess(ev3::MotorPtr motor, std::vector<int> powers = { 30, 60, 90 }, ev3::time_t stepTime = 0.6f);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	int getStartUpPower() const { return startUpPower; }
+	float getSpeedOnMaxPower() const { return speedOnMaxPower; }
+	float getTimeConstant() const { return timeConstant; }
+	float getMaxAcceleration() const { return maxAcceleration; }
+
+	/**
+	 * Мотор не начал вращаться при наибольшей мощности трогания
+	 */
+	bool isStartUpFailed() const { return startUpFailed; }
+
+	/**
+	 * Параметры модели найдены. Иначе геттеры возвращают параметры, с которыми мотор был до идентификации,
+	 * кроме найденной мощности трогания.
+	 */
+	bool isFitted() const { return fitted; }
+
+	/**
+	 * Установить найденные параметры мотору. Если параметры не найдены (см. isFitted), мотор не меняется.
+	 */
+	void apply() const;
+
+	/**
+	 * Запись параметров в файл. Если параметры не найдены (см. isFitted), файл не записывается.
+	 * @return false, если параметры не найдены или файл не удалось записать
+	 */
+	bool save(const char *filename) const;
+
+	/**
+	 * Чтение параметров из файла, записанного save, и установка их мотору
+	 * @return false, если файла нет
+	 */
+	static bool loadMotorModel(const ev3::MotorPtr &motor, const char *filename);
+
+protected:
+	enum class Phase {
+		START_UP,
+		STEPS,
+		DONE
+	};
+
+	ev3::MotorPtr motor;
+	std::vector<int> powers;
+	ev3::time_t stepTime;
+
+	Phase phase;
+	int rampPower;
+	ev3::time_t phaseStartTime;
+	int stepIndex;
+	float stepStartVelocity;
+	std::vector<std::pair<ev3::time_t, float>> samples;
+
+	std::vector<int> stepPowers;
+	std::vector<float> steadyVelocities;
+	std::vector<ev3::time_t> riseTimes;
+
+	int startUpPower;
+	float speedOnMaxPower;
+	float timeConstant;
+	float maxAcceleration;
+	bool startUpFailed;
+	bool fitted;
+
+private:
+	int getStepPower(int index) const;
+	void finishStep();
+	void fit();
+};
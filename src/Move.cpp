@@ -1,6 +1,29 @@
 #include "Move.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include <processes.h>
+#include <MotorArbiter.h>
+
+#include "WaitCrossByDistanceProcess.h"
+#include "TimeOptimalStopProcess.h"
+#include "ProfiledMoveProcess.h"
+#include "SyncDriveProcess.h"
+
+// поворот на месте на 90 градусов - 310 градусов энкодера на каждом колесе (см. rotateLeft)
+const float ROBOT_DEGREES_PER_ENCODER = 90.0f / 310;
+// расстояние от оси колёс до датчиков линии, мм
+const float LINE_SENSORS_DISTANCE = 80.0f;
+// смещение в мм умножается на этот коэффициент, чтобы вблизи линии ошибка была близка к разности показаний
+const float LINE_OFFSET_SCALE = 50.0f;
+const int LINE_CALIBRATION_ROTATION = 60;
+// пороги поиска перекрёстка, расстояние до которого известно (см. moveOnLineToCross(int, int, bool)):
+// до окна порог строже обычного (10), в окне - мягче
+const int CROSS_THRESHOLD_BEFORE_WINDOW = 6;
+const int CROSS_THRESHOLD_IN_WINDOW = 15;
+// доля максимальной скорости моторов для moveByProfile
+const float PROFILE_VELOCITY_MARGIN = 0.85f;
 
 Move::Move(std::shared_ptr<EV3> eva, std::shared_ptr<Motor> leftMotor, std::shared_ptr<Motor> rightMotor, std::shared_ptr<Sensor> leftLineSensor, std::shared_ptr<Sensor> rightLineSensor)
 : eva(std::move(eva))
@@ -10,7 +33,18 @@ Move::Move(std::shared_ptr<EV3> eva, std::shared_ptr<Motor> leftMotor, std::shar
 , rightLineSensor(std::move(rightLineSensor))
 , movePID(std::make_shared<PID>(0.3f, 0.0f, 0.9f))
 , power(70)
+, approachPower(50)
+, crossWindow(150)
+, brakingMode(BrakingMode::PID)
+, driveBackend(DriveBackend::PID)
+, hasBrakingProfile(false)
+, driveLimits({ 750.0f, 2500.0f, 25000.0f })
 {
+	followLeftSensor = this->leftLineSensor;
+	followRightSensor = this->rightLineSensor;
+	followPID = movePID;
+	linePositionPID = std::make_shared<PID>(0.3f, 0.0f, 0.9f);
+	alignStatistics = std::make_shared<AlignToLineStatistics>();
 
 }
 
@@ -22,89 +56,222 @@ int Move::getPower() const {
 	return power;
 }
 
+ev3::time_t Move::estimateTime(int distance, int power) const {
+	const float speed = std::min(leftMotor->getSpeedOnMaxPower(), rightMotor->getSpeedOnMaxPower()) * std::abs(power) / 100;
+	return speed > 0 ? std::abs(distance) / speed : 0.0f;
+}
+
+void Move::setApproachPower(int approachPower) {
+	this->approachPower = approachPower;
+}
+
+void Move::setCrossWindow(int crossWindow) {
+	this->crossWindow = crossWindow;
+}
+
+void Move::setLinePosition(std::shared_ptr<LinePosition> linePosition) {
+	if (linePosition) {
+		// MoveOnLineProcess регулирует по разности right - left, знак которой противоположен смещению
+		followLeftSensor = eva->getFakeSensor(linePosition->getOffsetWire(LINE_OFFSET_SCALE));
+		followRightSensor = eva->getFakeSensor(0);
+		followPID = linePositionPID;
+	} else {
+		followLeftSensor = leftLineSensor;
+		followRightSensor = rightLineSensor;
+		followPID = movePID;
+	}
+}
+
+std::shared_ptr<Process> Move::calibrateLinePosition(std::shared_ptr<LinePosition> linePosition) {
+	auto startEncoders = std::make_shared<std::pair<int, int>>();
+	auto start = [this, startEncoders, linePosition](float timestamp) {
+		*startEncoders = { leftMotor->getEncoder(), rightMotor->getEncoder() };
+		linePosition->startCalibration();
+		return false;
+	};
+	auto record = [this, startEncoders, linePosition](float timestamp) {
+		int rotation = ((rightMotor->getEncoder() - startEncoders->second) - (leftMotor->getEncoder() - startEncoders->first)) / 2;
+		float angle = rotation * ROBOT_DEGREES_PER_ENCODER * (float)M_PI / 180;
+		// при повороте влево датчики уходят влево, линия оказывается правее
+		linePosition->addCalibrationSample(LINE_SENSORS_DISTANCE * std::sin(angle));
+		return true;
+	};
+	auto finish = [linePosition](float timestamp) {
+		linePosition->finishCalibration();
+		return false;
+	};
+	const int calibrationPower = std::max(10, power / 5);
+	return claimDrive(std::make_shared<LambdaProcess>(start)
+			>> MoveByEncoderOnArcProcess(leftMotor, rightMotor, -LINE_CALIBRATION_ROTATION, LINE_CALIBRATION_ROTATION, calibrationPower)
+			>> (StopByEncoderOnArcProcess(leftMotor, rightMotor, 2 * LINE_CALIBRATION_ROTATION, -2 * LINE_CALIBRATION_ROTATION, calibrationPower)
+					& LambdaProcess(record))
+			>> StopByEncoderOnArcProcess(leftMotor, rightMotor, -LINE_CALIBRATION_ROTATION, LINE_CALIBRATION_ROTATION, calibrationPower)
+			>> LambdaProcess(finish));
+}
+
+void Move::setBrakingMode(BrakingMode brakingMode) {
+	this->brakingMode = brakingMode;
+}
+
+void Move::setBrakingProfile(const BrakingProfile &brakingProfile) {
+	this->brakingProfile = brakingProfile;
+	hasBrakingProfile = true;
+}
+
+std::shared_ptr<Process> Move::claimDrive(std::shared_ptr<Process> process) const {
+	return claimMotors(std::move(process), { leftMotor, rightMotor });
+}
+
+BrakingProfile Move::getBrakingProfile() const {
+	if (hasBrakingProfile) {
+		return brakingProfile;
+	}
+	// модель моторов загружается до создания Move, но может быть перезаписана идентификацией,
+	// поэтому кривая строится при каждой остановке
+	return BrakingProfile(std::min(leftMotor->getMaxAccelleration(), rightMotor->getMaxAccelleration()),
+			std::min(leftMotor->getSpeedOnMaxPower(), rightMotor->getSpeedOnMaxPower()),
+			std::max(leftMotor->getStartUpPower(), rightMotor->getStartUpPower()));
+}
+
+std::shared_ptr<Process> Move::stopOnLine(int distance, int power) {
+	if (brakingMode == BrakingMode::TIME_OPTIMAL) {
+		return claimDrive(std::make_shared<TimeOptimalStopProcess>(leftMotor, rightMotor, followLeftSensor, followRightSensor, distance, power, getBrakingProfile(), followPID));
+	}
+	return claimDrive(std::make_shared<StopOnLineProcess>(leftMotor, rightMotor, followLeftSensor, followRightSensor, distance, power, followPID));
+}
+
+std::shared_ptr<Process> Move::stopByEncoder(int leftDistance, int rightDistance, int power) {
+	if (brakingMode == BrakingMode::TIME_OPTIMAL) {
+		return claimDrive(std::make_shared<TimeOptimalStopProcess>(leftMotor, rightMotor, leftDistance, rightDistance, power, getBrakingProfile()));
+	}
+	return claimDrive(std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, leftDistance, rightDistance, power));
+}
+
 std::shared_ptr<Process> Move::moveOnLine(int distance, bool stop) {
 	if (stop) {
-		return std::make_shared<StopOnLineProcess>(leftMotor, rightMotor, leftLineSensor, rightLineSensor, distance, power, movePID);
+		return stopOnLine(distance, power);
 	} else {
-		return std::make_shared<MoveOnLineProcess>(leftMotor, rightMotor, leftLineSensor, rightLineSensor, distance, power, movePID);
+		return claimDrive(std::make_shared<MoveOnLineProcess>(leftMotor, rightMotor, followLeftSensor, followRightSensor, distance, power, followPID));
 	}
 }
 
 std::shared_ptr<Process> Move::moveOnLineToCross(int distanceAfterCross, bool stop) {
-	auto waitCrossProcess = std::make_shared<WaitCrossProcess>(leftMotor, rightMotor, leftLineSensor, rightLineSensor);
+	auto waitCrossProcess = std::make_shared<WaitCrossByDistanceProcess>(leftMotor, rightMotor, leftLineSensor, rightLineSensor);
 	waitCrossProcess->setMeanThreshold(10);
-	auto moveOnToCross = (MoveOnLineProcess(leftMotor, rightMotor, leftLineSensor, rightLineSensor, INT_MAX / 4, power, movePID)
+	auto moveOnToCross = (MoveOnLineProcess(leftMotor, rightMotor, followLeftSensor, followRightSensor, INT_MAX / 4, power, followPID)
 		& waitCrossProcess) >> LambdaProcess([this](float timestamp) {
 				eva->playSound(50, 0.1, 0.2);
 				return false;
 			});
 	if (stop) {
-		return moveOnToCross >> StopOnLineProcess(leftMotor, rightMotor, leftLineSensor, rightLineSensor, distanceAfterCross, power, movePID);
+		return claimDrive(moveOnToCross >> stopOnLine(distanceAfterCross, power));
+	} else {
+		return claimDrive(moveOnToCross >> MoveOnLineProcess(leftMotor, rightMotor, followLeftSensor, followRightSensor, distanceAfterCross, power, followPID));
+	}
+}
+
+std::shared_ptr<Process> Move::moveOnLineToCross(int expectedDistance, int distanceAfterCross, bool stop) {
+	int slowPower = std::min(power, approachPower);
+	int fullPowerDistance = std::max(0, expectedDistance - crossWindow);
+
+	// перекрёсток ищется на всём пути: до окна со строгим порогом, чтобы найти ранний перекрёсток
+	// (проскальзывание, неточная длина ребра), в окне - с мягким
+	auto waitCrossProcess = std::make_shared<WaitCrossByDistanceProcess>(leftMotor, rightMotor, leftLineSensor, rightLineSensor);
+	waitCrossProcess->setMeanThreshold(CROSS_THRESHOLD_BEFORE_WINDOW);
+	waitCrossProcess->setWindow(fullPowerDistance, CROSS_THRESHOLD_IN_WINDOW);
+	std::shared_ptr<Process> moveOnLine = std::make_shared<MoveOnLineProcess>(leftMotor, rightMotor, followLeftSensor, followRightSensor, INT_MAX / 4, slowPower, followPID);
+	if (fullPowerDistance > 0) {
+		moveOnLine = MoveOnLineProcess(leftMotor, rightMotor, followLeftSensor, followRightSensor, fullPowerDistance, power, followPID)
+			>> moveOnLine;
+	}
+	auto moveOnToCross = (moveOnLine & waitCrossProcess) >> LambdaProcess([this](float timestamp) {
+				eva->playSound(50, 0.1, 0.2);
+				return false;
+			});
+	// после перекрёстка робот продолжает с мощностью подъезда, разгон - в следующем движении
+	if (stop) {
+		return claimDrive(moveOnToCross >> stopOnLine(distanceAfterCross, slowPower));
 	} else {
-		return moveOnToCross >> MoveOnLineProcess(leftMotor, rightMotor, leftLineSensor, rightLineSensor, distanceAfterCross, power, movePID);
+		return claimDrive(moveOnToCross >> MoveOnLineProcess(leftMotor, rightMotor, followLeftSensor, followRightSensor, distanceAfterCross, slowPower, followPID));
 	}
 }
 
 std::shared_ptr<Process> Move::moveToCross(int distanceAfterCross, bool stop) {
 	auto moveOnToCross = MoveByEncoderOnArcProcess(leftMotor, rightMotor, INT_MAX / 4, INT_MAX / 4, power)
-		& WaitCrossProcess(leftMotor, rightMotor, leftLineSensor, rightLineSensor);
+		& WaitCrossByDistanceProcess(leftMotor, rightMotor, leftLineSensor, rightLineSensor);
 	if (stop) {
-		return moveOnToCross >> StopByEncoderOnArcProcess(leftMotor, rightMotor, distanceAfterCross, distanceAfterCross, power);
+		return claimDrive(moveOnToCross >> stopByEncoder(distanceAfterCross, distanceAfterCross, power));
 	} else {
-		return moveOnToCross >> MoveByEncoderOnArcProcess(leftMotor, rightMotor, distanceAfterCross, distanceAfterCross, power);
+		return claimDrive(moveOnToCross >> MoveByEncoderOnArcProcess(leftMotor, rightMotor, distanceAfterCross, distanceAfterCross, power));
 	}
 }
 
 std::shared_ptr<Process> Move::moveByEncoder(int leftDistance, int rightDistance, bool stop) {
+	return driveByEncoder(leftDistance, rightDistance, power, stop);
+}
+
+void Move::setDriveBackend(DriveBackend driveBackend) {
+	this->driveBackend = driveBackend;
+}
+
+std::shared_ptr<Process> Move::driveByEncoder(int leftDistance, int rightDistance, int power, bool stop) {
+	if (driveBackend == DriveBackend::FIRMWARE_SYNC) {
+		return claimDrive(std::make_shared<SyncDriveProcess>(leftMotor, rightMotor, leftDistance, rightDistance, power, stop));
+	}
 	if (stop) {
-		return std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, leftDistance, rightDistance, power);
+		return stopByEncoder(leftDistance, rightDistance, power);
 	} else {
-		return std::make_shared<MoveByEncoderOnArcProcess>(leftMotor, rightMotor, leftDistance, rightDistance, power);
+		return claimDrive(std::make_shared<MoveByEncoderOnArcProcess>(leftMotor, rightMotor, leftDistance, rightDistance, power));
 	}
 }
 
+std::shared_ptr<Process> Move::moveByProfile(int leftDistance, int rightDistance) {
+	// как и у крана, скорость профиля не выше, чем моторы могут развить с запасом мощности для регулятора
+	MotionProfile::Limits limits = driveLimits;
+	limits.maxVelocity = std::min(limits.maxVelocity, PROFILE_VELOCITY_MARGIN * std::min(leftMotor->getSpeedOnMaxPower(), rightMotor->getSpeedOnMaxPower()));
+	limits.maxAcceleration = std::min(limits.maxAcceleration, std::min(leftMotor->getMaxAccelleration(), rightMotor->getMaxAccelleration()));
+	return claimDrive(std::make_shared<ProfiledMoveProcess>(leftMotor, rightMotor, leftDistance, rightDistance, limits));
+}
+
+void Move::setDriveLimits(const MotionProfile::Limits &driveLimits) {
+	this->driveLimits = driveLimits;
+}
+
 std::shared_ptr<Process> Move::rotateToLineLeft(int minDistance, bool stop) {
-	movePID->reset();
-	return MoveByEncoderOnArcProcess(leftMotor, rightMotor, -minDistance, minDistance, power / 2)
+	followPID->reset();
+	return claimDrive(MoveByEncoderOnArcProcess(leftMotor, rightMotor, -minDistance, minDistance, power / 2)
 					>> (MoveByEncoderOnArcProcess(leftMotor, rightMotor, -INT_MAX/4, INT_MAX/4, power / 2)
 							& WaitLineProcess(leftLineSensor))
-					>> alignToLine(stop);
+					>> alignToLine(stop));
 
 }
 
 std::shared_ptr<Process> Move::rotateToLineRight(int minDistance, bool stop) {
-	movePID->reset();
-	return MoveByEncoderOnArcProcess(leftMotor, rightMotor, minDistance, -minDistance, power / 2)
+	followPID->reset();
+	return claimDrive(MoveByEncoderOnArcProcess(leftMotor, rightMotor, minDistance, -minDistance, power / 2)
 					>> (MoveByEncoderOnArcProcess(leftMotor, rightMotor, INT_MAX/4, -INT_MAX/4, power / 2)
 							& WaitLineProcess(rightLineSensor))
-					>> alignToLine(stop);
+					>> alignToLine(stop));
 }
 
 std::shared_ptr<Process> Move::alignToLine(bool stop) {
-	auto alignProcess = LambdaProcess([this](float timestamp) {
-		float delta = rightLineSensor->getValue() - leftLineSensor->getValue();
-		rightMotor->setPower(delta / 2);
-		leftMotor->setPower(-delta / 2);
-		return abs(delta) > 5;
-	}) & WaitTimeProcess(0.5f);
+	// выравнивание - по разности показаний самих датчиков: пороги завершения AlignToLineProcess
+	// заданы в их единицах, у оценки положения линии (followLeftSensor) другая шкала
+	auto alignProcess = std::make_shared<AlignToLineProcess>(leftMotor, rightMotor, leftLineSensor, rightLineSensor, alignStatistics);
 	if (stop) {
-		return alignProcess >> (StopProcess(leftMotor) | StopProcess(rightMotor));
+		return claimDrive(alignProcess >> (StopProcess(leftMotor) | StopProcess(rightMotor)));
 	}
-	return alignProcess;
+	return claimDrive(alignProcess);
+}
+
+const AlignToLineStatistics& Move::getAlignStatistics() const {
+	return *alignStatistics;
 }
 
 std::shared_ptr<Process> Move::rotateLeft(bool stop) {
-	if (stop) {
-		return std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, -310, 310, power / 2);
-	} else {
-		return std::make_shared<MoveByEncoderOnArcProcess>(leftMotor, rightMotor, -310, 310, power / 2);
-	}
+	return driveByEncoder(-310, 310, power / 2, stop);
 }
 
 std::shared_ptr<Process> Move::rotateRight(bool stop) {
-	if (stop) {
-		return std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, 310, -310, power / 2);
-	} else {
-		return std::make_shared<MoveByEncoderOnArcProcess>(leftMotor, rightMotor, 310, -310, power / 2);
-	}
+	return driveByEncoder(310, -310, power / 2, stop);
 }
@@ -6,11 +6,32 @@
 #include <Motor.h>
 #include <Sensor.h>
 #include <PID.h>
+#include <BrakingProfile.h>
+#include <MotionProfile.h>
+
+#include "LinePosition.h"
+#include "AlignToLineProcess.h"
 
 using namespace ev3;
 
 class Move final {
 public:
+	/**
+	 * Способ остановки в конце движения
+	 */
+	enum class BrakingMode {
+		PID,          //!< StopOnLineProcess и StopByEncoderOnArcProcess
+		TIME_OPTIMAL, //!< TimeOptimalStopProcess по кривой торможения
+	};
+
+	/**
+	 * Способ синхронизации колёс при движении по энкодерам (moveByEncoder, rotateLeft, rotateRight)
+	 */
+	enum class DriveBackend {
+		PID,           //!< MoveByEncoderOnArcProcess, регулятор на каждом такте
+		FIRMWARE_SYNC, //!< SyncDriveProcess, синхронизация в прошивке
+	};
+
 	Move(std::shared_ptr<EV3> eva, std::shared_ptr<Motor> leftMotor, std::shared_ptr<Motor> rightMotor, std::shared_ptr<Sensor> leftLineSensor, std::shared_ptr<Sensor> rightLineSensor);
 
 	virtual ~Move() = default;
@@ -18,10 +39,96 @@ public:
 	void setPower(int power);
 	int getPower() const;
 
+	/**
+	 * Оценка времени движения на расстояние с постоянной мощностью по скорости моторов на максимальной
+	 * мощности (см. Motor::setSpeedOnMaxPower). Разгон, торможение и выравнивание не учитываются,
+	 * поэтому оценка - нижняя граница.
+	 * @param distance расстояние в градусах энкодера
+	 * @param power мощность
+	 * @return время в секундах
+	 */
+	ev3::time_t estimateTime(int distance, int power) const;
+
+	/**
+	 * Мощность при подъезде к перекрёстку, см. moveOnLineToCross(int, int, bool)
+	 */
+	void setApproachPower(int approachPower);
+
+	/**
+	 * Расстояние до ожидаемого перекрёстка, на котором начинается его поиск
+	 * @param crossWindow расстояние в градусах энкодера
+	 */
+	void setCrossWindow(int crossWindow);
+
+	void setBrakingMode(BrakingMode brakingMode);
+
+	void setDriveBackend(DriveBackend driveBackend);
+
+	/**
+	 * Установить кривую торможения для режима BrakingMode::TIME_OPTIMAL.
+	 * По умолчанию кривая строится по модели моторов (см. getBrakingProfile).
+	 */
+	void setBrakingProfile(const BrakingProfile &brakingProfile);
+
+	/**
+	 * Движение по линии с остановкой. В отличие от moveOnLine мощность задаётся явно.
+	 */
+	std::shared_ptr<Process> stopOnLine(int distance, int power);
+
+	/**
+	 * Движение по дуге с остановкой. В отличие от moveByEncoder мощность задаётся явно.
+	 */
+	std::shared_ptr<Process> stopByEncoder(int leftDistance, int rightDistance, int power);
+
+	/**
+	 * Движение по линии по смещению в миллиметрах вместо разности показаний датчиков.
+	 * Оценка должна быть откалибрована (см. calibrateLinePosition или LinePosition::load).
+	 * Датчики линии по-прежнему используются для поиска перекрёстков.
+	 * @param linePosition оценка положения линии, nullptr - движение по разности показаний
+	 */
+	void setLinePosition(std::shared_ptr<LinePosition> linePosition);
+
+	/**
+	 * Калибровка оценки положения линии. Робот стоит на линии, поворачивается влево,
+	 * затем вправо, записывая показания датчиков и смещение, вычисленное по энкодерам,
+	 * и возвращается в исходное положение.
+	 * @param linePosition оценка положения линии
+	 */
+	std::shared_ptr<Process> calibrateLinePosition(std::shared_ptr<LinePosition> linePosition);
+
+	/**
+	 * Статистика времени выравнивания на линии (см. alignToLine)
+	 */
+	const AlignToLineStatistics& getAlignStatistics() const;
+
 	std::shared_ptr<Process> moveOnLine(int distance, bool stop);
 	std::shared_ptr<Process> moveOnLineToCross(int distanceAfterCross, bool stop);
+
+	/**
+	 * Движение по линии до перекрёстка, расстояние до которого известно.
+	 * До окна перед перекрёстком робот едет с полной мощностью, в окне снижает мощность до approachPower.
+	 * Перекрёсток ищется на всём пути: до окна со строгим порогом, в окне - с мягким, поэтому
+	 * перекрёсток, встретившийся раньше ожидаемого, не пропускается. После перекрёстка робот
+	 * продолжает движение с мощностью approachPower.
+	 * @param expectedDistance ожидаемое расстояние до перекрёстка в градусах энкодера
+	 * @param distanceAfterCross расстояние, которое нужно проехать после перекрёстка
+	 * @param stop остановиться в конце
+	 */
+	std::shared_ptr<Process> moveOnLineToCross(int expectedDistance, int distanceAfterCross, bool stop);
 	std::shared_ptr<Process> moveToCross(int distanceAfterCross, bool stop);
 	std::shared_ptr<Process> moveByEncoder(int leftDistance, int rightDistance, bool stop);
+
+	/**
+	 * Движение по энкодерам по профилю скорости с ограничением ускорения и рывка.
+	 * Робот всегда останавливается в конце.
+	 */
+	std::shared_ptr<Process> moveByProfile(int leftDistance, int rightDistance);
+
+	/**
+	 * Установить ограничения скорости, ускорения и рывка для moveByProfile.
+	 * Скорость и ускорение дополнительно ограничиваются моделью моторов.
+	 */
+	void setDriveLimits(const MotionProfile::Limits &driveLimits);
 	std::shared_ptr<Process> rotateToLineLeft(int minDistance, bool stop);
 	std::shared_ptr<Process> rotateToLineRight(int minDistance, bool stop);
 	std::shared_ptr<Process> alignToLine(bool stop);
@@ -29,6 +136,8 @@ public:
 	std::shared_ptr<Process> rotateRight(bool stop);
 
 private:
+	std::shared_ptr<Process> driveByEncoder(int leftDistance, int rightDistance, int power, bool stop);
+
 	std::shared_ptr<EV3> eva;
 	std::shared_ptr<Motor> leftMotor;
 	std::shared_ptr<Motor> rightMotor;
@@ -37,6 +146,33 @@ private:
 
 	std::shared_ptr<PID> movePID;
 
+	// датчики и регулятор для движения по линии: исходные датчики или смещение из LinePosition
+	std::shared_ptr<Sensor> followLeftSensor;
+	std::shared_ptr<Sensor> followRightSensor;
+	std::shared_ptr<PID> followPID;
+	std::shared_ptr<PID> linePositionPID;
+
+	std::shared_ptr<AlignToLineStatistics> alignStatistics;
+
 	int power;
+	int approachPower;
+	int crossWindow;
+	BrakingMode brakingMode;
+	DriveBackend driveBackend;
+	BrakingProfile brakingProfile;
+	bool hasBrakingProfile;
+	MotionProfile::Limits driveLimits;
+
+	/**
+	 * Кривая торможения: заданная через setBrakingProfile или по модели моторов - замедление
+	 * Motor::getMaxAccelleration, скорость на максимальной мощности и мощность трогания
+	 */
+	BrakingProfile getBrakingProfile() const;
+
+	/**
+	 * Процессы движения управляют моторами через арбитров (см. MotorClaimProcess), чтобы одновременное
+	 * управление колёсами из разных веток дерева процессов было видно в findMotorConflicts
+	 */
+	std::shared_ptr<Process> claimDrive(std::shared_ptr<Process> process) const;
 };
 
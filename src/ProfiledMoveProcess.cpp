@@ -0,0 +1,144 @@
+#include "ProfiledMoveProcess.h"
+
+#include <cmath>
+#include <cstdlib>
+
+ProfiledMoveProcess::ProfiledMoveProcess(ev3::MotorPtr motor, int targetEncoder, const ev3::MotionProfile::Limits &limits)
+: numberOfAxes(0)
+, absoluteTarget(true)
+, targetEncoder(targetEncoder)
+, limits(limits)
+, encoderThreshold(10)
+, maxTrackingError(150)
+, timeoutMargin(1.0f)
+, feedforward(true)
+, startTime(0)
+, completed(false)
+, failed(false)
+{
+	addAxis(std::move(motor), 0);
+}
+
+ProfiledMoveProcess::ProfiledMoveProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance,
+		const ev3::MotionProfile::Limits &limits)
+: numberOfAxes(0)
+, absoluteTarget(false)
+, targetEncoder(0)
+, limits(limits)
+, encoderThreshold(10)
+, maxTrackingError(150)
+, timeoutMargin(1.0f)
+, feedforward(true)
+, startTime(0)
+, completed(false)
+, failed(false)
+{
+	addAxis(std::move(leftMotor), leftEncoderDistance);
+	addAxis(std::move(rightMotor), rightEncoderDistance);
+}
+
+void ProfiledMoveProcess::addAxis(ev3::MotorPtr motor, int distance) {
+	Axis &axis = axes[numberOfAxes++];
+	axis.dynamics = ev3::MotorDynamics::of(motor);
+	axis.motor = std::move(motor);
+	axis.distance = distance;
+	axis.error = std::make_shared<float>(0.0f);
+	axis.pid = std::make_shared<ev3::PID>(0.5f, 0.0f, 1.0f);
+	auto error = axis.error;
+	axis.pid->setError(ev3::WireF([error] { return *error; }));
+}
+
+void ProfiledMoveProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (completed) {
+		return;
+	}
+	const ev3::time_t t = secondsFromStart - startTime;
+	const ev3::MotionProfile::State state = profile.getState(t);
+	bool onTarget = t >= profile.getDuration();
+	bool lost = t >= profile.getDuration() + timeoutMargin;
+	for (int i = 0; i < numberOfAxes; ++i) {
+		Axis &axis = axes[i];
+		float target = axis.encoderStart + state.position * axis.scale;
+		*axis.error = target - axis.motor->getEncoder();
+		axis.pid->update(secondsFromStart);
+		float power = axis.pid->getPower();
+		if (feedforward) {
+			power += axis.dynamics->getFeedforwardPower(state.velocity * axis.scale, state.acceleration * axis.scale);
+		}
+		axis.motor->setPower(power > 100 ? 100 : (power < -100 ? -100 : (int)power));
+		onTarget = onTarget && std::fabs(*axis.error) <= encoderThreshold;
+		lost = lost || std::fabs(*axis.error) > maxTrackingError;
+	}
+	if (onTarget) {
+		complete(false);
+	} else if (lost) {
+		complete(true);
+	}
+}
+
+void ProfiledMoveProcess::complete(bool failed) {
+	completed = true;
+	this->failed = failed;
+	for (int i = 0; i < numberOfAxes; ++i) {
+		axes[i].motor->setPower(0);
+	}
+}
+
+void ProfiledMoveProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	startTime = secondsFromStart;
+	completed = false;
+	failed = false;
+
+	if (absoluteTarget) {
+		axes[0].distance = targetEncoder - axes[0].motor->getEncoder();
+	}
+	int leading = 0;
+	for (int i = 0; i < numberOfAxes; ++i) {
+		axes[i].encoderStart = axes[i].motor->getEncoder();
+		axes[i].pid->reset();
+		if (std::abs(axes[i].distance) > std::abs(axes[leading].distance)) {
+			leading = i;
+		}
+	}
+	const int distance = axes[leading].distance;
+	profile = ev3::MotionProfile(distance, limits);
+	for (int i = 0; i < numberOfAxes; ++i) {
+		axes[i].scale = distance == 0 ? 0.0f : (float)axes[i].distance / distance;
+	}
+}
+
+bool ProfiledMoveProcess::isCompleted(ev3::time_t) {
+	return completed;
+}
+
+void ProfiledMoveProcess::setEncoderThreshold(int encoderThreshold) {
+	this->encoderThreshold = encoderThreshold;
+}
+
+void ProfiledMoveProcess::setMaxTrackingError(int maxTrackingError) {
+	this->maxTrackingError = maxTrackingError;
+}
+
+void ProfiledMoveProcess::setTimeoutMargin(ev3::time_t timeoutMargin) {
+	this->timeoutMargin = timeoutMargin;
+}
+
+bool ProfiledMoveProcess::isFailed() const {
+	return failed;
+}
+
+void ProfiledMoveProcess::setPID(float kp, float ki, float kd) {
+	for (int i = 0; i < numberOfAxes; ++i) {
+		axes[i].pid->setPID(kp, ki, kd);
+	}
+}
+
+void ProfiledMoveProcess::setFeedforward(bool feedforward) {
+	this->feedforward = feedforward;
+}
+
+ev3::time_t ProfiledMoveProcess::getDuration() const {
+	return profile.getDuration();
+}
@@ -0,0 +1,116 @@
+/*
+ * ProfiledMoveProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+#include <PID.h>
+#include <MotionProfile.h>
+#include <MotorDynamics.h>
+
+#include <memory>
+
+/**
+ * Движение одного мотора или пары моторов по профилю (см. MotionProfile).
+ * На каждом такте профиль задаёт целевое положение, скорость и ускорение. Мощность складывается
+ * из прямой связи по модели мотора (см. MotorDynamics::getFeedforwardPower) и ПИД-регулятора, который
+ * отрабатывает только отклонение положения от профиля.
+ * Для пары моторов профиль строится для большего расстояния, цель второго мотора масштабируется,
+ * поэтому оба колеса приходят одновременно.
+ * Процесс завершается, когда профиль закончился и ошибка положения не больше encoderThreshold.
+ * Процесс прерывается (см. isFailed), если ошибка положения превысила maxTrackingError (упор,
+ * профиль не по силам мотору) или движение длится дольше профиля больше чем на timeoutMargin.
+ */
+class ProfiledMoveProcess : public virtual ev3::Process {
+public:
+	/**
+	 * Движение одного мотора к абсолютному значению энкодера (как MoveToEncoderAndStopProcess)
+	 */
+	ProfiledMoveProcess(ev3::MotorPtr motor, int targetEncoder, const ev3::MotionProfile::Limits &limits);
+
+	/**
+	 * Движение пары моторов на заданные расстояния (как MoveByEncoderOnArcProcess)
+	 */
+	ProfiledMoveProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance,
+			const ev3::MotionProfile::Limits &limits);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	/**
+	 * Допустимое отклонение от требуемого значения энкодера, при котором завершается процесс
+	 * @param encoderThreshold значение по умолчанию 10
+	 */
+	void setEncoderThreshold(int encoderThreshold);
+
+	/**
+	 * Максимальное отклонение от профиля, при котором движение прерывается
+	 * @param maxTrackingError значение в градусах, по умолчанию 150
+	 */
+	void setMaxTrackingError(int maxTrackingError);
+
+	/**
+	 * Допустимое время сверх длительности профиля, после которого движение прерывается
+	 * @param timeoutMargin время в секундах, по умолчанию 1
+	 */
+	void setTimeoutMargin(ev3::time_t timeoutMargin);
+
+	/**
+	 * Движение было прервано по ошибке положения или по времени
+	 */
+	bool isFailed() const;
+
+	/**
+	 * Установить коэффициенты ПИД-регулятора положения
+	 * Значения по умолчанию: 0.5f, 0, 1.0f
+	 */
+	void setPID(float kp, float ki, float kd);
+
+	/**
+	 * Включить или выключить прямую связь по модели мотора
+	 * @param feedforward значение по умолчанию true
+	 */
+	void setFeedforward(bool feedforward);
+
+	/**
+	 * Время движения по профилю в секундах
+	 */
+	ev3::time_t getDuration() const;
+
+protected:
+	static const int MAX_MOTORS = 2;
+
+	struct Axis {
+		ev3::MotorPtr motor;
+		std::shared_ptr<ev3::MotorDynamics> dynamics;
+		int distance = 0;
+		int encoderStart = 0;
+		float scale = 1;
+		std::shared_ptr<float> error;
+		std::shared_ptr<ev3::PID> pid;
+	};
+
+	void addAxis(ev3::MotorPtr motor, int distance);
+	void complete(bool failed);
+
+	Axis axes[MAX_MOTORS];
+	int numberOfAxes;
+	bool absoluteTarget;
+	int targetEncoder;
+
+	ev3::MotionProfile::Limits limits;
+	ev3::MotionProfile profile;
+	int encoderThreshold;
+	int maxTrackingError;
+	ev3::time_t timeoutMargin;
+	bool feedforward;
+	ev3::time_t startTime;
+	bool completed;
+	bool failed;
+};
@@ -0,0 +1,67 @@
+#include "StallProcess.h"
+
+#include <MotorDynamics.h>
+
+#include <cmath>
+
+// мотору нужно время, чтобы разогнаться, до этого низкая скорость не означает упор
+const ev3::time_t START_UP_TIME = 0.1f;
+
+StallProcess::StallProcess(ev3::MotorPtr motor, int power, int holdPower)
+: motor(std::move(motor))
+, power(power)
+, holdPower(holdPower)
+, stallVelocity(20)
+, stallTicks(3)
+, timeout(1.5f)
+, startTime(0)
+, numberOfStallTicks(0)
+, stalled(false)
+, stallEncoder(0)
+, completed(false)
+{
+}
+
+void StallProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (completed) {
+		return;
+	}
+	// скорость читается на каждом такте, чтобы оценка обновлялась
+	const float velocity = ev3::MotorDynamics::of(motor)->getVelocity();
+	const ev3::time_t t = secondsFromStart - startTime;
+	if (t >= START_UP_TIME && std::fabs(velocity) < stallVelocity) {
+		numberOfStallTicks++;
+	} else {
+		numberOfStallTicks = 0;
+	}
+
+	stalled = numberOfStallTicks >= stallTicks;
+	if (stalled || t >= timeout) {
+		stallEncoder = motor->getEncoder();
+		motor->setPower(holdPower);
+		completed = true;
+	}
+}
+
+void StallProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	startTime = secondsFromStart;
+	numberOfStallTicks = 0;
+	stalled = false;
+	completed = false;
+	motor->setPower(power);
+}
+
+bool StallProcess::isCompleted(ev3::time_t) {
+	return completed;
+}
+
+void StallProcess::setStallCriterion(float stallVelocity, int stallTicks) {
+	this->stallVelocity = stallVelocity;
+	this->stallTicks = stallTicks;
+}
+
+void StallProcess::setTimeout(ev3::time_t timeout) {
+	this->timeout = timeout;
+}
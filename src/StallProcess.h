@@ -0,0 +1,68 @@
+/*
+ * StallProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+
+/**
+ * Вращение мотора до упора. Упор определяется по падению скорости (см. MotorDynamics):
+ * скорость должна оставаться меньше stallVelocity в течение stallTicks тактов подряд.
+ * После остановки на мотор подаётся удерживающая мощность, и процесс сразу завершается.
+ * Если упор не найден за timeout, процесс тоже завершается с удерживающей мощностью.
+ */
+class StallProcess : public virtual ev3::Process {
+public:
+	/**
+	 * @param motor мотор
+	 * @param power мощность движения до упора
+	 * @param holdPower мощность удержания после остановки
+	 */
+	StallProcess(ev3::MotorPtr motor, int power, int holdPower);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	/**
+	 * Установить условие остановки
+	 * @param stallVelocity скорость в градусах за секунду, по умолчанию 20
+	 * @param stallTicks количество тактов подряд, по умолчанию 3
+	 */
+	void setStallCriterion(float stallVelocity, int stallTicks);
+
+	/**
+	 * Установить максимальное время движения
+	 * @param timeout время в секундах, по умолчанию 1.5
+	 */
+	void setTimeout(ev3::time_t timeout);
+
+	/**
+	 * Мотор остановился на упоре (а не по истечении времени)
+	 */
+	bool isStalled() const { return stalled; }
+
+	/**
+	 * Значение энкодера в момент остановки
+	 */
+	int getStallEncoder() const { return stallEncoder; }
+
+protected:
+	ev3::MotorPtr motor;
+	int power;
+	int holdPower;
+	float stallVelocity;
+	int stallTicks;
+	ev3::time_t timeout;
+
+	ev3::time_t startTime;
+	int numberOfStallTicks;
+	bool stalled;
+	int stallEncoder;
+	bool completed;
+};
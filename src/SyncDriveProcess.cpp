@@ -0,0 +1,88 @@
+#include "SyncDriveProcess.h"
+
+#include <core/ev3_output.h>
+#include <MotorArbiter.h>
+
+#include <cmath>
+#include <cstdlib>
+
+// расстояние в градусах исходного энкодера мотора: без учёта направления и масштаба
+static float rawDistance(const ev3::MotorPtr &motor, int distance) {
+	float raw = distance / motor->getEncoderScale();
+	return motor->getDirection() == ev3::Motor::Direction::BACKWARD ? -raw : raw;
+}
+
+SyncDriveProcess::SyncDriveProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance,
+		int maxPower, bool useBrake)
+: leftMotor(std::move(leftMotor))
+, rightMotor(std::move(rightMotor))
+, leftEncoderDistance(leftEncoderDistance)
+, rightEncoderDistance(rightEncoderDistance)
+, maxPower(maxPower)
+, useBrake(useBrake)
+, commandSent(false)
+, completed(false)
+{
+}
+
+void SyncDriveProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (completed) {
+		return;
+	}
+	if (!commandSent) {
+		// прошивка считает первым мотор с меньшим номером порта
+		const bool leftIsFirst = (uint8_t)leftMotor->getPort() < (uint8_t)rightMotor->getPort();
+		const float first = rawDistance(leftIsFirst ? leftMotor : rightMotor, leftIsFirst ? leftEncoderDistance : rightEncoderDistance);
+		const float second = rawDistance(leftIsFirst ? rightMotor : leftMotor, leftIsFirst ? rightEncoderDistance : leftEncoderDistance);
+		if (first == 0 && second == 0) {
+			completed = true;
+			return;
+		}
+
+		// turn > 0: второй мотор вращается со скоростью speed * (1 - turn / 100), шаги считаются по первому
+		// turn < 0: первый мотор вращается со скоростью speed * (1 + turn / 100), шаги считаются по второму
+		int8_t speed;
+		short turn;
+		int step;
+		if (std::fabs(first) >= std::fabs(second)) {
+			speed = (int8_t)(first > 0 ? maxPower : -maxPower);
+			turn = (short)std::lround(100 * (1 - second / first));
+			step = (int)std::lround(std::fabs(first));
+		} else {
+			speed = (int8_t)(second > 0 ? maxPower : -maxPower);
+			turn = (short)std::lround(-100 * (1 - first / second));
+			step = (int)std::lround(std::fabs(second));
+		}
+		OutputStepSyncEx(getOutputs(), speed, turn, step, useBrake, OWNER_NONE);
+		commandSent = true;
+		return;
+	}
+	// флаг занятости выставляется прошивкой не сразу, поэтому проверяем его со следующего такта
+	completed = !leftMotor->isBusy() && !rightMotor->isBusy();
+}
+
+void SyncDriveProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	commandSent = false;
+	completed = false;
+	ev3::MotorOutputAccess::detach(*leftMotor);
+	ev3::MotorOutputAccess::detach(*rightMotor);
+}
+
+void SyncDriveProcess::onCompleted(ev3::time_t secondsFromStart) {
+	Process::onCompleted(secondsFromStart);
+	if (commandSent && !completed) {
+		// процесс прерван, а прошивка ещё выполняет команду
+		OutputStop(getOutputs(), useBrake);
+		completed = true;
+	}
+}
+
+bool SyncDriveProcess::isCompleted(ev3::time_t) {
+	return completed;
+}
+
+uint8_t SyncDriveProcess::getOutputs() const {
+	return (uint8_t)leftMotor->getPort() | (uint8_t)rightMotor->getPort();
+}
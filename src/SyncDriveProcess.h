@@ -0,0 +1,55 @@
+/*
+ * SyncDriveProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+
+/**
+ * Движение по энкодерам с синхронизацией моторов в прошивке (OutputStepSyncEx).
+ * Соотношение скоростей колёс постоянно, поэтому подходит для прямых и дуг постоянного радиуса.
+ * Команда отправляется один раз при старте, затем процесс только проверяет, заняты ли моторы,
+ * поэтому на каждом такте не тратится время на регулятор, а колёса синхронизируются точнее.
+ *
+ * При старте с моторов снимаются провода мощности, иначе обновление моторов в EV3 на следующем
+ * такте перезапишет команду прошивки последней мощностью. Если процесс прерван раньше, чем прошивка
+ * закончила движение (например, в группе &), моторы останавливаются (OutputStop).
+ * В MotorClaimProcess арбитр не возвращает снятые провода (см. MotorOutputAccess::detach).
+ */
+class SyncDriveProcess : public virtual ev3::Process {
+public:
+	/**
+	 * @param leftMotor левый мотор
+	 * @param rightMotor правый мотор
+	 * @param leftEncoderDistance расстояние для левого мотора в градусах энкодера
+	 * @param rightEncoderDistance расстояние для правого мотора в градусах энкодера
+	 * @param maxPower мощность более быстрого мотора (от 0 до 100)
+	 * @param useBrake тормозить в конце (иначе моторы останавливаются свободно)
+	 */
+	SyncDriveProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance,
+			int maxPower, bool useBrake);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual void onCompleted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+protected:
+	ev3::MotorPtr leftMotor;
+	ev3::MotorPtr rightMotor;
+	int leftEncoderDistance;
+	int rightEncoderDistance;
+	int maxPower;
+	bool useBrake;
+
+	bool commandSent;
+	bool completed;
+
+private:
+	uint8_t getOutputs() const;
+};
@@ -0,0 +1,62 @@
+#include "TableColorProcess.h"
+
+#include <algorithm>
+
+TableColorProcess::TableColorProcess(std::shared_ptr<ev3::ColorSensor> colorSensor, std::shared_ptr<const ev3::ColorLookupTable<>> table, int numberOfColors, ev3::time_t duration)
+: colorSensor(colorSensor)
+, samples(ev3::SensorSamples::of(colorSensor))
+, table(std::move(table))
+, duration(duration)
+, votes(numberOfColors - ev3::NO_COLOR, 0)
+, numberOfSamples(0)
+, startTime(0)
+, completed(false)
+{
+}
+
+void TableColorProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (completed) {
+		return;
+	}
+	if (samples->isNewSample()) {
+		vote(table->getColorIndex(colorSensor->getRGBColor()));
+	}
+	if (secondsFromStart - startTime >= duration) {
+		if (numberOfSamples == 0) {
+			vote(table->getColorIndex(colorSensor->getRGBColor()));
+		}
+		completed = true;
+	}
+}
+
+void TableColorProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	std::fill(votes.begin(), votes.end(), 0);
+	numberOfSamples = 0;
+	startTime = secondsFromStart;
+	completed = false;
+}
+
+bool TableColorProcess::isCompleted(ev3::time_t) {
+	return completed;
+}
+
+int TableColorProcess::getColor() const {
+	// при равенстве голосов выбирается первый цвет с наибольшим числом голосов, как в GetColorProcess
+	int best = 0;
+	for (size_t i = 1; i < votes.size(); ++i) {
+		if (votes[i] > votes[best]) {
+			best = (int)i;
+		}
+	}
+	return votes[best] == 0 ? ev3::NO_COLOR : best + ev3::NO_COLOR;
+}
+
+void TableColorProcess::vote(int color) {
+	const int index = color - ev3::NO_COLOR;
+	if (index >= 0 && index < (int)votes.size()) {
+		votes[index]++;
+		numberOfSamples++;
+	}
+}
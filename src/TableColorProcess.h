@@ -0,0 +1,62 @@
+/*
+ * TableColorProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Sensor.h>
+#include <SensorSamples.h>
+#include <ColorLookupTable.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Определение цвета, как GetColorProcess: за время duration выбирается наиболее встречаемый цвет.
+ * Цвет классифицируется по таблице (см. ColorLookupTable), а голосуют только новые значения датчика
+ * (см. SensorSamples), поэтому датчик, обновляющийся реже цикла, не учитывает одно значение несколько раз.
+ * Если за время процесса нового значения не было, голосует последнее прочитанное.
+ */
+class TableColorProcess : public virtual ev3::Process {
+public:
+	/**
+	 * @param colorSensor датчик цвета
+	 * @param table таблица, построенная для набора цветов и порогов; одну таблицу используют все процессы
+	 * @param numberOfColors количество цветов, по которым построена таблица
+	 * @param duration время определения цвета в секундах
+	 */
+	TableColorProcess(std::shared_ptr<ev3::ColorSensor> colorSensor, std::shared_ptr<const ev3::ColorLookupTable<>> table, int numberOfColors, ev3::time_t duration = 0.1f);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	/**
+	 * Наиболее встречаемый цвет, значения те же, что у GetColorProcess::getColor:
+	 * индекс в массиве цветов или BLACK_COLOR, WHITE_COLOR, NO_COLOR
+	 */
+	int getColor() const;
+
+	/**
+	 * Количество значений, которые голосовали
+	 */
+	int getNumberOfSamples() const { return numberOfSamples; }
+
+protected:
+	void vote(int color);
+
+	std::shared_ptr<ev3::ColorSensor> colorSensor;
+	std::shared_ptr<ev3::SensorSamples> samples;
+	std::shared_ptr<const ev3::ColorLookupTable<>> table;
+	ev3::time_t duration;
+
+	// голоса по цветам, со сдвигом на -NO_COLOR
+	std::vector<int> votes;
+	int numberOfSamples;
+	ev3::time_t startTime;
+	bool completed;
+};
@@ -0,0 +1,125 @@
+#include "TimeOptimalStopProcess.h"
+
+#include <processes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+TimeOptimalStopProcess::TimeOptimalStopProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight,
+		int encoderDistance, int maxPower, const ev3::BrakingProfile &profile, std::shared_ptr<ev3::PID> pid)
+: leftMotor(leftMotor)
+, rightMotor(rightMotor)
+, leftEncoderDistance(encoderDistance)
+, rightEncoderDistance(encoderDistance)
+, leftEncoderStart(0)
+, rightEncoderStart(0)
+, maxPower(maxPower)
+, distanceThreshold(5)
+, speedThreshold(3)
+, holdTimeout(0.3f)
+, profile(profile)
+, holding(false)
+, holdStart(0)
+, completed(false)
+{
+	// движение по линии завершается позже, остановку определяет этот процесс
+	auto moveOnLineProcess = std::make_shared<ev3::MoveOnLineProcess>(leftMotor, rightMotor, std::move(leftLight), std::move(rightLight),
+			encoderDistance * 2, maxPower, std::move(pid));
+	moveProcess = moveOnLineProcess;
+	setMovePower = [moveOnLineProcess](int power) { moveOnLineProcess->setMaxPower(power); };
+}
+
+TimeOptimalStopProcess::TimeOptimalStopProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance,
+		int maxPower, const ev3::BrakingProfile &profile)
+: leftMotor(leftMotor)
+, rightMotor(rightMotor)
+, leftEncoderDistance(leftEncoderDistance)
+, rightEncoderDistance(rightEncoderDistance)
+, leftEncoderStart(0)
+, rightEncoderStart(0)
+, maxPower(maxPower)
+, distanceThreshold(5)
+, speedThreshold(3)
+, holdTimeout(0.3f)
+, profile(profile)
+, holding(false)
+, holdStart(0)
+, completed(false)
+{
+	auto moveByEncoderProcess = std::make_shared<ev3::MoveByEncoderOnArcProcess>(leftMotor, rightMotor,
+			leftEncoderDistance * 2, rightEncoderDistance * 2, maxPower);
+	moveProcess = moveByEncoderProcess;
+	setMovePower = [moveByEncoderProcess](int power) { moveByEncoderProcess->setMaxPower(power); };
+}
+
+void TimeOptimalStopProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (completed) {
+		return;
+	}
+	if (holding) {
+		// моторы удерживаются на цели, пока не остановятся
+		bool stopped = std::abs(leftMotor->getActualSpeed()) <= speedThreshold && std::abs(rightMotor->getActualSpeed()) <= speedThreshold;
+		if (stopped || secondsFromStart - holdStart >= holdTimeout) {
+			completed = true;
+		}
+		return;
+	}
+	float remaining = getRemaining();
+	if (remaining <= distanceThreshold) {
+		hold(secondsFromStart);
+		return;
+	}
+	setMovePower(profile.getPower(remaining, maxPower));
+	moveProcess->update(secondsFromStart);
+}
+
+void TimeOptimalStopProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	leftEncoderStart = leftMotor->getEncoder();
+	rightEncoderStart = rightMotor->getEncoder();
+	holding = false;
+	completed = false;
+}
+
+bool TimeOptimalStopProcess::isCompleted(ev3::time_t) {
+	return completed;
+}
+
+void TimeOptimalStopProcess::setDistanceThreshold(int distanceThreshold) {
+	this->distanceThreshold = distanceThreshold;
+}
+
+void TimeOptimalStopProcess::setSpeedThreshold(int speedThreshold) {
+	this->speedThreshold = speedThreshold;
+}
+
+void TimeOptimalStopProcess::setHoldTimeout(ev3::time_t holdTimeout) {
+	this->holdTimeout = holdTimeout;
+}
+
+void TimeOptimalStopProcess::hold(ev3::time_t secondsFromStart) {
+	// без активного торможения (мощность 0) робот докатывается по инерции дальше цели.
+	// Цель каждого колеса - его текущее положение плюс остаток пути в пропорции дуги:
+	// на линии колёса проходят разный путь, и блокировка на start + distance развернула бы робота
+	float remaining = std::max(0.0f, getRemaining());
+	int leading = std::max(std::abs(leftEncoderDistance), std::abs(rightEncoderDistance));
+	int leftTarget = leftMotor->getEncoder();
+	int rightTarget = rightMotor->getEncoder();
+	if (leading > 0) {
+		leftTarget += (int)std::lround(remaining * leftEncoderDistance / leading);
+		rightTarget += (int)std::lround(remaining * rightEncoderDistance / leading);
+	}
+	leftMotor->blockOnEncoder(leftTarget);
+	rightMotor->blockOnEncoder(rightTarget);
+	holding = true;
+	holdStart = secondsFromStart;
+}
+
+float TimeOptimalStopProcess::getRemaining() const {
+	// на дуге ведущим считается колесо с большим путём
+	int leftRemaining = std::abs(leftEncoderDistance) - std::abs(leftMotor->getEncoder() - leftEncoderStart);
+	int rightRemaining = std::abs(rightEncoderDistance) - std::abs(rightMotor->getEncoder() - rightEncoderStart);
+	return std::abs(leftEncoderDistance) >= std::abs(rightEncoderDistance) ? leftRemaining : rightRemaining;
+}
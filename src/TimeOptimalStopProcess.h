@@ -0,0 +1,83 @@
+/*
+ * TimeOptimalStopProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+#include <Sensor.h>
+#include <PID.h>
+#include <BrakingProfile.h>
+#include <InplaceFunction.h>
+
+#include <memory>
+
+/**
+ * Движение с остановкой за минимальное время. Мощность ограничивается кривой торможения
+ * (см. BrakingProfile). Когда до цели остаётся не больше distanceThreshold, моторы блокируются
+ * на целевом значении енкодера (активное торможение), и процесс завершается после остановки моторов.
+ * Замена StopOnLineProcess и StopByEncoderOnArcProcess, которые тормозят ПИД-регулятором мощности.
+ */
+class TimeOptimalStopProcess : public virtual ev3::Process {
+public:
+	/**
+	 * Движение по линии с остановкой
+	 */
+	TimeOptimalStopProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight,
+			int encoderDistance, int maxPower, const ev3::BrakingProfile &profile, std::shared_ptr<ev3::PID> pid = nullptr);
+
+	/**
+	 * Движение по дуге с остановкой
+	 */
+	TimeOptimalStopProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance,
+			int maxPower, const ev3::BrakingProfile &profile);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	/**
+	 * Допустимое отклонение от требуемого значения енкодера в градусах, при котором завершается процесс
+	 * @param distanceThreshold значение по умолчанию 5
+	 */
+	void setDistanceThreshold(int distanceThreshold);
+
+	/**
+	 * Скорость на моторах (actual speed), при которой завершается торможение
+	 * @param speedThreshold минимальная скорость, значение по умолчанию 3
+	 */
+	void setSpeedThreshold(int speedThreshold);
+
+	/**
+	 * Максимальное время удержания моторов на целевом значении енкодера
+	 * @param holdTimeout время в секундах, по умолчанию 0.3
+	 */
+	void setHoldTimeout(ev3::time_t holdTimeout);
+
+protected:
+	ev3::MotorPtr leftMotor;
+	ev3::MotorPtr rightMotor;
+	int leftEncoderDistance;
+	int rightEncoderDistance;
+	int leftEncoderStart;
+	int rightEncoderStart;
+	int maxPower;
+	int distanceThreshold;
+	int speedThreshold;
+	ev3::time_t holdTimeout;
+	ev3::BrakingProfile profile;
+
+	std::shared_ptr<ev3::Process> moveProcess;
+	ev3::InplaceFunction<void(int)> setMovePower;
+	bool holding;
+	ev3::time_t holdStart;
+	bool completed;
+
+private:
+	float getRemaining() const;
+	void hold(ev3::time_t secondsFromStart);
+};
@@ -0,0 +1,75 @@
+#include "WaitCrossByDistanceProcess.h"
+
+#include <cstdlib>
+
+WaitCrossByDistanceProcess::WaitCrossByDistanceProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight)
+: leftMotor(std::move(leftMotor))
+, rightMotor(std::move(rightMotor))
+, leftLight(std::move(leftLight))
+, rightLight(std::move(rightLight))
+, leftSamples(ev3::SensorSamples::of(this->leftLight))
+, rightSamples(ev3::SensorSamples::of(this->rightLight))
+, meanThreshold(50)
+, windowStart(-1)
+, windowMeanThreshold(50)
+, leftStartEncoder(0)
+, rightStartEncoder(0)
+, foundCross(false)
+{
+}
+
+void WaitCrossByDistanceProcess::update(ev3::time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	// повторное значение не добавляет информации: пропущенное расстояние будет интерполировано
+	// между старым и новым значением при следующем новом значении, поэтому сторона обновляется
+	// только при новом значении своего датчика.
+	// Без счётчиков обновлений (см. SensorMemory::trackSamples) учитывается каждый такт
+	const bool leftNew = leftSamples->isNewSample();
+	const bool rightNew = rightSamples->isNewSample();
+	if (!foundCross && (leftNew || rightNew)) {
+		const int leftEncoder = leftMotor->getEncoder();
+		const int rightEncoder = rightMotor->getEncoder();
+		if (windowStart >= 0) {
+			const int distance = (std::abs(leftEncoder - leftStartEncoder) + std::abs(rightEncoder - rightStartEncoder)) / 2;
+			detector.setMeanThreshold(distance >= windowStart ? windowMeanThreshold : meanThreshold);
+		}
+		if (leftNew) {
+			detector.updateLeft(leftEncoder, leftLight->getValue());
+		}
+		if (rightNew) {
+			detector.updateRight(rightEncoder, rightLight->getValue());
+		}
+		foundCross = detector.isDetected();
+	}
+}
+
+void WaitCrossByDistanceProcess::onStarted(ev3::time_t secondsFromStart) {
+	Process::onStarted(secondsFromStart);
+	foundCross = false;
+	leftStartEncoder = leftMotor->getEncoder();
+	rightStartEncoder = rightMotor->getEncoder();
+	detector.setMeanThreshold(meanThreshold);
+	detector.reset(leftStartEncoder, rightStartEncoder);
+}
+
+bool WaitCrossByDistanceProcess::isCompleted(ev3::time_t) {
+	return foundCross;
+}
+
+void WaitCrossByDistanceProcess::setMeanThreshold(int meanThreshold) {
+	this->meanThreshold = meanThreshold;
+	detector.setMeanThreshold(meanThreshold);
+}
+
+void WaitCrossByDistanceProcess::setSampleStep(int sampleStep) {
+	detector.setSampleStep(sampleStep);
+}
+
+void WaitCrossByDistanceProcess::setMaxSkew(int maxSkew) {
+	detector.setMaxSkew(maxSkew);
+}
+
+void WaitCrossByDistanceProcess::setWindow(int windowStart, int windowMeanThreshold) {
+	this->windowStart = windowStart;
+	this->windowMeanThreshold = windowMeanThreshold;
+}
@@ -0,0 +1,70 @@
+/*
+ * WaitCrossByDistanceProcess.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ */
+
+#pragma once
+
+#include <Process.h>
+#include <Motor.h>
+#include <Sensor.h>
+#include <SensorSamples.h>
+#include <CrossDetector.h>
+
+/**
+ * Ожидание перекрёстка. Значения датчиков линии записываются по пройденному расстоянию
+ * (см. CrossDetector), поэтому срабатывание не зависит от частоты цикла и мощности моторов.
+ */
+class WaitCrossByDistanceProcess : public virtual ev3::Process {
+public:
+	WaitCrossByDistanceProcess(ev3::MotorPtr leftMotor, ev3::MotorPtr rightMotor, ev3::SensorPtr leftLight, ev3::SensorPtr rightLight);
+
+	virtual void update(ev3::time_t secondsFromStart) override;
+	virtual void onStarted(ev3::time_t secondsFromStart) override;
+	virtual bool isCompleted(ev3::time_t secondsFromStart) override;
+
+	/**
+	 * Установить пороговое среднее значение яркости в окне
+	 * @param meanThreshold значение по умолчанию 50
+	 */
+	void setMeanThreshold(int meanThreshold);
+
+	/**
+	 * Установить расстояние между записываемыми значениями
+	 * @param sampleStep шаг в градусах энкодера, по умолчанию 1
+	 */
+	void setSampleStep(int sampleStep);
+
+	/**
+	 * Установить наибольшее расстояние между срабатываниями левого и правого датчика
+	 * @param maxSkew расстояние в градусах энкодера, по умолчанию 20
+	 */
+	void setMaxSkew(int maxSkew);
+
+	/**
+	 * Установить окно, в котором ожидается перекрёсток. До окна используется порог setMeanThreshold,
+	 * в окне - windowMeanThreshold. Обычно порог до окна строже, чтобы случайное затемнение не приняли
+	 * за перекрёсток, но ранний перекрёсток (проскальзывание колёс) всё равно был найден.
+	 * @param windowStart расстояние от начала процесса до окна в градусах энкодера
+	 * @param windowMeanThreshold пороговое среднее значение яркости в окне
+	 */
+	void setWindow(int windowStart, int windowMeanThreshold);
+
+protected:
+	ev3::MotorPtr leftMotor;
+	ev3::MotorPtr rightMotor;
+	ev3::SensorPtr leftLight;
+	ev3::SensorPtr rightLight;
+	std::shared_ptr<ev3::SensorSamples> leftSamples;
+	std::shared_ptr<ev3::SensorSamples> rightSamples;
+
+	ev3::CrossDetector<> detector;
+	int meanThreshold;
+	int windowStart;
+	int windowMeanThreshold;
+	int leftStartEncoder;
+	int rightStartEncoder;
+	bool foundCross;
+};
@@ -1,5 +1,7 @@
 #include <ev3.h>
 #include <processes.h>
+#include <MotorArbiter.h>
+#include <SensorMemory.h>
 #include <array>
 #include <memory>
 #include <map>
@@ -9,6 +11,9 @@
 #include "Graph.h"
 #include "Grabber.h"
 #include "Crane.h"
+#include "LinePosition.h"
+#include "MotorIdentificationProcess.h"
+#include "TableColorProcess.h"
 
 #include "DebugFunctions.h"
 
@@ -23,8 +28,14 @@ enum class BarrelState {
 const int NUMBER_OF_BARRELS = 6;
 const int power = 100;
 const int ONE_BARREL_ANGLE = 80;
+const int DISTANCE_AFTER_CROSS = 155; // от перекрёстка до центра робота
+const int BLIND_DISTANCE = 500; // движение по линии без поиска перекрёстка, если длина ребра не измерена
+const int TURN_ENCODER = 310; // поворот на 90 градусов
+const ev3::time_t GRABBER_OPEN_TIME = 0.5f;
+const ev3::time_t CRANE_TIME_MARGIN = 0.5f; // запас на неточность оценки времени движения робота
 const bool USE_CHECK = false;
 const bool USE_DEBUG_WAIT = false;
+const bool USE_SENSOR_MEMORY = true; // счётчики обновлений драйвера датчиков (SensorMemory) для отбора новых значений
 
 const std::vector<int> colors = {
 		0, // красный
@@ -48,11 +59,15 @@ std::shared_ptr<EV3> eva;
 std::shared_ptr<Move> move;
 std::shared_ptr<Grabber> grabber;
 std::shared_ptr<Crane> crane;
+std::shared_ptr<LinePosition> linePosition;
+int edgeLength = 0; // расстояние между соседними перекрёстками в градусах энкодера, 0 - не измерено (debugMeasureEdgeLength)
 
 std::shared_ptr<RawReflectedLightSensor> leftLight;
 std::shared_ptr<RawReflectedLightSensor> rightLight;
 std::shared_ptr<ColorSensor> colorSensor;
 std::shared_ptr<Sensor> distSensor;
+ev3::SensorMemory sensorMemory;
+std::shared_ptr<const ColorLookupTable<>> colorTable; // классификация цветов бочек (TableColorProcess)
 
 std::shared_ptr<Motor> leftMotor;
 std::shared_ptr<Motor> rightMotor;
@@ -72,6 +87,7 @@ void debugWait(ev3::time_t waitTime);
 void initBarrels();
 void setupSensors();
 void setupMotors();
+void loadEdgeLength();
 
 int findNearestBarrel();
 std::vector<Action> findPathToBarrel(Node position);
@@ -79,6 +95,7 @@ int findNextBarrel(int barrel);
 std::pair<Node, bool> grabNextBarrel(int distance);
 void checkNextBarrel(int barrel);
 std::vector<Action> findPathToStore(Node position);
+ev3::time_t estimateTime(const std::vector<Action>& actions);
 void goToNode(const std::vector<Action>& actions, bool upperShelf, bool barrel);
 void putBarrel();
 void outputBarrels();
@@ -99,6 +116,11 @@ int main()
 	crane = std::make_shared<Crane>(craneMotor);
 	move = std::make_shared<Move>(eva, leftMotor, rightMotor, leftLight, rightLight);
 	move->setPower(power);
+	linePosition = std::make_shared<LinePosition>(leftLight, rightLight);
+	if (linePosition->load("/home/root/lms2012/prjs/robofinist2023/line.txt")) {
+		move->setLinePosition(linePosition);
+	}
+	loadEdgeLength();
 
 //	debugSomething();
 
@@ -120,7 +142,7 @@ int main()
 		grabBarrel();
 		int color = -3;
 		for (int j = 0; j < 5; ++j) {
-			auto getColorProcess = std::make_shared<GetColorProcess>(colorSensor, colors, 0.5f);
+			auto getColorProcess = std::make_shared<TableColorProcess>(colorSensor, colorTable, (int)colors.size(), 0.5f);
 			eva->runProcess(getColorProcess);
 			color = getColorProcess->getColor();
 			if (color != -3) {
@@ -159,6 +181,7 @@ void debugSomething() {
 //	eva->runProcess(move->moveOnLineToCross(500, true));
 
 //	debugColors(eva, colorSensor, colors);
+//	debugColorLookupBenchmark(eva, colorSensor, colors);
 
 	eva.reset();
 	exit(0);
@@ -178,6 +201,17 @@ void initBarrels() {
 	}
 }
 
+void loadEdgeLength() {
+	FILE* fIn = fopen("/home/root/lms2012/prjs/robofinist2023/edge.txt", "r");
+	if (fIn == nullptr) {
+		return;
+	}
+	if (fscanf(fIn, "%d", &edgeLength) != 1 || edgeLength <= DISTANCE_AFTER_CROSS) {
+		edgeLength = 0;
+	}
+	fclose(fIn);
+}
+
 void setupSensors() {
 	eva->initSensors(Sensor::Mode::COLOR_REFLECT_RAW, Sensor::Mode::COLOR_REFLECT_RAW, Sensor::Mode::COLOR_RGB, Sensor::Mode::INFRARED_PROXIMITY);
 
@@ -204,8 +238,17 @@ void setupSensors() {
 	colorSensor->setMaxGValue(maxG);
 	colorSensor->setMinBValue(0); // 6
 	colorSensor->setMaxBValue(maxB);
+	// таблица строится по откалиброванному RGB, поэтому не зависит от калибровки выше
+	colorTable = std::make_shared<ColorLookupTable<>>(colors);
 
 	distSensor = eva->getSensor(Sensor::Port::P4);
+
+	// без отображения памяти драйвера процессы считают новым значением каждый такт
+	if (USE_SENSOR_MEMORY && sensorMemory.map()) {
+		sensorMemory.attach(leftLight);
+		sensorMemory.attach(rightLight);
+		sensorMemory.attach(colorSensor);
+	}
 }
 
 void setupMotors() {
@@ -240,6 +283,12 @@ void setupMotors() {
 	rightMotor->setMaxAccelleration(50000.0f);
 	craneMotor->setMaxAccelleration(500000.0f);
 	grabMotor->setMaxAccelleration(500000.0f);
+
+	// параметры моторов, найденные debugIdentifyMotors, если они есть
+	MotorIdentificationProcess::loadMotorModel(leftMotor, "/home/root/lms2012/prjs/robofinist2023/motorB.txt");
+	MotorIdentificationProcess::loadMotorModel(rightMotor, "/home/root/lms2012/prjs/robofinist2023/motorA.txt");
+	MotorIdentificationProcess::loadMotorModel(craneMotor, "/home/root/lms2012/prjs/robofinist2023/motorC.txt");
+	MotorIdentificationProcess::loadMotorModel(grabMotor, "/home/root/lms2012/prjs/robofinist2023/motorD.txt");
 }
 
 // MARK: Strategy
@@ -284,6 +333,25 @@ std::vector<Action> findPathToBarrel(Node position) {
 	return actions;
 }
 
+ev3::time_t estimateTime(const std::vector<Action>& actions) {
+	ev3::time_t time = 0;
+	for (Action action : actions) {
+		switch (action) {
+		case Action::FORWARD:
+			time += move->estimateTime(edgeLength > 0 ? edgeLength : BLIND_DISTANCE + DISTANCE_AFTER_CROSS, move->getPower());
+			break;
+		case Action::TURN_LEFT:
+		case Action::TURN_RIGHT:
+			time += move->estimateTime(TURN_ENCODER, move->getPower() / 2);
+			break;
+		case Action::TURN_AROUND:
+			time += move->estimateTime(2 * TURN_ENCODER, move->getPower() / 2);
+			break;
+		}
+	}
+	return time;
+}
+
 void goToNode(const std::vector<Action>& actions, bool upperShelf, bool barrel) {
 	std::shared_ptr<Process> moveProcess;
 	for (size_t i = 0; i < actions.size(); ++i) {
@@ -291,10 +359,13 @@ void goToNode(const std::vector<Action>& actions, bool upperShelf, bool barrel)
 		bool stop = i == actions.size() - 1 || actions[i] != actions[i + 1];
 		switch (actions[i]) {
 		case Action::FORWARD:
-			if (barrel && stop) {
-				nextMove = move->moveOnLine(500, false) >> move->moveOnLineToCross(100, stop);
+			// каждое действие начинается на DISTANCE_AFTER_CROSS после перекрёстка
+			if (edgeLength > 0) {
+				nextMove = move->moveOnLineToCross(edgeLength - DISTANCE_AFTER_CROSS, barrel && stop ? 100 : DISTANCE_AFTER_CROSS, stop);
+			} else if (barrel && stop) {
+				nextMove = move->moveOnLine(BLIND_DISTANCE, false) >> move->moveOnLineToCross(100, stop);
 			} else {
-				nextMove = move->moveOnLine(500, false) >> move->moveOnLineToCross(155, stop);
+				nextMove = move->moveOnLine(BLIND_DISTANCE, false) >> move->moveOnLineToCross(DISTANCE_AFTER_CROSS, stop);
 			}
 			break;
 		case Action::TURN_LEFT:
@@ -312,15 +383,27 @@ void goToNode(const std::vector<Action>& actions, bool upperShelf, bool barrel)
 
 	std::shared_ptr<Process> craneProcess = upperShelf
 			? crane->up() : (barrel ? (grabber->open() >> WaitTimeProcess(0.2f) >> crane->down()) : crane->freeToMove());
+	ev3::time_t craneTime = upperShelf
+			? crane->estimateUp() : (barrel ? GRABBER_OPEN_TIME + 0.2f + crane->estimateDown() : crane->estimateFreeToMove());
+	// кран трогается как можно позже, но так, чтобы закончить до приезда робота
+	ev3::time_t craneDelay = estimateTime(actions) - craneTime - CRANE_TIME_MARGIN;
+	if (moveProcess != nullptr && craneDelay > 0) {
+		craneProcess = std::make_shared<WaitTimeProcess>(craneDelay) >> craneProcess;
+	}
+	std::shared_ptr<Process> process;
 	if (moveProcess == nullptr) {
-		eva->runProcess(craneProcess);
+		process = craneProcess;
 	} else {
 		if (barrel) {
-			eva->runProcess(moveProcess | craneProcess);
+			process = moveProcess | craneProcess;
 		} else {
-			eva->runProcess((moveProcess | craneProcess) >> move->moveOnLineToCross(55, true));
+			process = (moveProcess | craneProcess) >> move->moveOnLineToCross(55, true);
 		}
 	}
+	for (const MotorConflict &conflict : findMotorConflicts(process)) {
+		eva->lcdPrintf(Color::BLACK, "motor %d conflict\n", (int)conflict.port);
+	}
+	eva->runProcess(process);
 }
 
 void putBarrel() {
@@ -416,14 +499,14 @@ std::pair<Node, bool> grabNextBarrel(int distToMove) {
 			>> (std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, 50, 50, 50) | grabber->close());
 	eva->runProcess(moveToBarrel >> grabber->close());
 
-	auto getColorProcess = std::make_shared<GetColorProcess>(colorSensor, colors, 0.2f);
+	auto getColorProcess = std::make_shared<TableColorProcess>(colorSensor, colorTable, (int)colors.size(), 0.2f);
 	// возвращаемся к перекрёстку
 	eva->runProcess(std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, -200 - distToMove, -200 - distToMove, 50)
 			| getColorProcess);
 
 	int color = getColorProcess->getColor();
 	if (color < -2 || color > 3) {
-		getColorProcess = std::make_shared<GetColorProcess>(colorSensor, colors, 0.5f);
+		getColorProcess = std::make_shared<TableColorProcess>(colorSensor, colorTable, (int)colors.size(), 0.5f);
 		eva->runProcess(getColorProcess);
 		color = getColorProcess->getColor();
 		if (color < -2 || color > 3) {
@@ -462,13 +545,13 @@ void checkNextBarrel(int lastBarrel) {
 		return;
 	}
 
-	ev3::time_t prevTimestamp = eva->timestamp();
+	ev3::ticks_t prevTicks = eva->readTicks();
 	int prevDistance = 51;
 	int startEncoder = leftMotor->getEncoder();
 
 	eva->runProcess(StopByEncoderOnArcProcess(leftMotor, rightMotor, degreesToRotate + ONE_BARREL_ANGLE / 2, -degreesToRotate - ONE_BARREL_ANGLE / 2, 30)
 					& LambdaProcess([&](ev3::time_t timestamp) {
-		if (timestamp - prevTimestamp > 0.05f) {
+		if (eva->ticks() - prevTicks > 50 * TICKS_PER_MILLISECOND) {
 			int distance = distSensor->getValue();
 			if (prevDistance < 60 && distance < 60) {
 				int delta = leftMotor->getEncoder() - startEncoder;
@@ -507,6 +590,9 @@ void grabBarrel() {
 	eva->runProcess(std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, dist + 55, dist + 55, 50)
 			>> grabber->close()
 			>> std::make_shared<StopByEncoderOnArcProcess>(leftMotor, rightMotor, -dist, -dist, 50));
+	if (!grabber->isBarrelGripped()) {
+		eva->playSound(1000, 0.3f, 0.3f);
+	}
 }
 
 void putBarrelShort() {
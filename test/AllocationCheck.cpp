@@ -0,0 +1,180 @@
+/*
+ * AllocationCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Подсчёт выделений памяти в проводах и в дереве процессов goToNode, выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include -Isrc -Itest test/AllocationCheck.cpp src/Move.cpp src/Crane.cpp src/Grabber.cpp \
+ *       src/AlignToLineProcess.cpp src/TimeOptimalStopProcess.cpp src/ProfiledMoveProcess.cpp src/SyncDriveProcess.cpp \
+ *       src/WaitCrossByDistanceProcess.cpp src/StallProcess.cpp src/LinePosition.cpp -o allocations && ./allocations
+ *
+ * Счётчик заменяет глобальный operator new только в этой программе, в программе робота выделение памяти не меняется.
+ * Классы библиотеки заменены заглушками (см. LibraryStubs.h), поэтому на тактах считаются выделения
+ * только в процессах программы (захват моторов, поиск перекрёстка и т.п.), но не в процессах библиотеки.
+ *
+ * Проверяется, что вычисление проводов и такты дерева процессов после первого не выделяют память;
+ * количество выделений при построении выражений и дерева выводится для сравнения.
+ */
+
+#include "LibraryStubs.h"
+
+#include <WireExpression.h>
+#include <MotorArbiter.h>
+
+#include "Move.h"
+#include "Crane.h"
+#include "Grabber.h"
+#include "Graph.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+static bool countAllocations = false;
+static int numberOfAllocations = 0;
+
+void* operator new(std::size_t size) {
+	if (countAllocations) {
+		numberOfAllocations++;
+	}
+	void *memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void *memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+static void startCounting() {
+	numberOfAllocations = 0;
+	countAllocations = true;
+}
+
+static int stopCounting() {
+	countAllocations = false;
+	return numberOfAllocations;
+}
+
+// те же значения, что в robofinist2023
+const int DISTANCE_AFTER_CROSS = 155;
+const int BLIND_DISTANCE = 500;
+
+/**
+ * Дерево процессов, которое строит goToNode в robofinist2023 для маршрута без бочки
+ */
+static std::shared_ptr<ev3::Process> buildGoToNode(const std::shared_ptr<Move> &move, const std::shared_ptr<Crane> &crane,
+		const std::vector<Action> &actions, int edgeLength) {
+	std::shared_ptr<ev3::Process> moveProcess;
+	for (size_t i = 0; i < actions.size(); ++i) {
+		std::shared_ptr<ev3::Process> nextMove;
+		bool stop = i == actions.size() - 1 || actions[i] != actions[i + 1];
+		switch (actions[i]) {
+		case Action::FORWARD:
+			if (edgeLength > 0) {
+				nextMove = move->moveOnLineToCross(edgeLength - DISTANCE_AFTER_CROSS, DISTANCE_AFTER_CROSS, stop);
+			} else {
+				nextMove = move->moveOnLine(BLIND_DISTANCE, false) >> move->moveOnLineToCross(DISTANCE_AFTER_CROSS, stop);
+			}
+			break;
+		case Action::TURN_LEFT:
+			nextMove = move->rotateToLineLeft(50, stop);
+			break;
+		case Action::TURN_RIGHT:
+			nextMove = move->rotateToLineRight(50, stop);
+			break;
+		case Action::TURN_AROUND:
+			nextMove = move->rotateToLineRight(50, false) >> move->rotateToLineRight(200, stop);
+			break;
+		}
+		moveProcess = i == 0 ? nextMove : (moveProcess >> nextMove);
+	}
+	std::shared_ptr<ev3::Process> craneProcess = std::make_shared<ev3::WaitTimeProcess>(1.0f) >> crane->freeToMove();
+	std::shared_ptr<ev3::Process> process = (moveProcess | craneProcess) >> move->moveOnLineToCross(55, true);
+	ev3::findMotorConflicts(process);
+	return process;
+}
+
+static bool check(const char *name, int allocations, int maxAllocations) {
+	const bool ok = maxAllocations < 0 || allocations <= maxAllocations;
+	printf("%-28s %5d: %s\n", name, allocations, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main() {
+	const int iterations = 1000;
+	bool ok = true;
+
+	// выражение глубины 8 из debugWireBenchmark
+	int source = 0;
+	ev3::WireI left([&source] { return source; });
+	ev3::WireI right([&source] { return 1024 - source; });
+	int checksum = 0;
+
+	startCounting();
+	ev3::WireI wire = ((left - right) * 3 + (right - left) / 2) * ((left + right) - (left * 2 - right)) + 1;
+	ok = check("wire build", stopCounting(), -1) && ok;
+
+	startCounting();
+	for (int i = 0; i < iterations; ++i) {
+		source = i & 1023;
+		checksum += wire.getValue();
+	}
+	ok = check("wire evaluate x1000", stopCounting(), 0) && ok;
+
+	startCounting();
+	auto expression = ((ev3::wireExpr(left) - right) * 3 + (ev3::wireExpr(right) - left) / 2)
+			* ((ev3::wireExpr(left) + right) - (ev3::wireExpr(left) * 2 - right)) + 1;
+	for (int i = 0; i < iterations; ++i) {
+		source = i & 1023;
+		checksum -= expression.getValue();
+	}
+	ok = check("expression x1000", stopCounting(), 0) && ok;
+
+	startCounting();
+	ev3::WireI expressionWire = expression;
+	ok = check("expression to wire", stopCounting(), -1) && ok;
+	checksum += expressionWire.getValue();
+
+	// дерево процессов goToNode: вперёд, налево, вперёд
+	ev3::MotorPtr leftMotor = std::make_shared<ev3::TestMotor>(ev3::Motor::Port::B);
+	ev3::MotorPtr rightMotor = std::make_shared<ev3::TestMotor>(ev3::Motor::Port::A);
+	ev3::MotorPtr craneMotor = std::make_shared<ev3::TestMotor>(ev3::Motor::Port::C);
+	ev3::SensorPtr leftLight = std::make_shared<ev3::TestSensor>(ev3::Sensor::Port::P1);
+	ev3::SensorPtr rightLight = std::make_shared<ev3::TestSensor>(ev3::Sensor::Port::P2);
+	auto move = std::make_shared<Move>(nullptr, leftMotor, rightMotor, leftLight, rightLight);
+	auto crane = std::make_shared<Crane>(craneMotor);
+	const std::vector<Action> actions = { Action::FORWARD, Action::TURN_LEFT, Action::FORWARD };
+
+	for (int edgeLength : { 0, 700 }) {
+		startCounting();
+		std::shared_ptr<ev3::Process> process = buildGoToNode(move, crane, actions, edgeLength);
+		ok = check(edgeLength > 0 ? "goToNode build (edge)" : "goToNode build (blind)", stopCounting(), -1) && ok;
+
+		// первый такт запускает процессы и устанавливает провода арбитров
+		ev3::Clock::enterLoop();
+		ev3::ticks_t now = 0;
+		ev3::Clock::beginTick(now);
+		process->update(ev3::Clock::tickSeconds());
+		startCounting();
+		for (int i = 0; i < 100; ++i) {
+			now += 10 * ev3::TICKS_PER_MILLISECOND;
+			ev3::Clock::beginTick(now);
+			process->update(ev3::Clock::tickSeconds());
+			checksum += leftMotor->getPower() + rightMotor->getPower();
+		}
+		ok = check("goToNode ticks x100", stopCounting(), 0) && ok;
+		ev3::Clock::leaveLoop();
+	}
+
+	printf("checksum %d\n", checksum);
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+/*
+ * ColorLookupTableCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Проверка ColorLookupTable, выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include test/ColorLookupTableCheck.cpp -o color_table && ./color_table
+ *
+ * Таблица должна совпадать с классификацией без таблицы в центре каждой ячейки, включая нижнюю,
+ * а NO_COLOR возвращаться только для значения, у которого все компоненты равны 0.
+ */
+
+#include <ColorLookupTable.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// цвета бочек, как в robofinist2023
+const std::vector<int> colors = { 0, 60, 120, 240 };
+const int BITS = 5;
+
+int main() {
+	ev3::ColorLookupTable<BITS> table(colors);
+	const int shift = 8 - BITS;
+	const int center = (1 << shift) >> 1;
+
+	int numberOfMismatches = 0;
+	for (int r = 0; r < table.LEVELS; ++r) {
+		for (int g = 0; g < table.LEVELS; ++g) {
+			for (int b = 0; b < table.LEVELS; ++b) {
+				const ev3::RGB rgb((unsigned char)((r << shift) + center), (unsigned char)((g << shift) + center), (unsigned char)((b << shift) + center));
+				if (table.getColorIndex(rgb) != ev3::ColorLookupTable<BITS>::classify(rgb, colors, 10, 20, 60)) {
+					numberOfMismatches++;
+				}
+			}
+		}
+	}
+	const bool centersOk = numberOfMismatches == 0;
+	printf("%-20s %5d mismatches: %s\n", "cell centers", numberOfMismatches, centersOk ? "ok" : "FAILED");
+
+	const bool zeroOk = table.getColorIndex(ev3::RGB()) == ev3::NO_COLOR;
+	printf("%-20s %5d: %s\n", "(0, 0, 0)", table.getColorIndex(ev3::RGB()), zeroOk ? "ok" : "FAILED");
+
+	// в нижней ячейке, кроме (0, 0, 0), датчик видит тёмный объект
+	const ev3::RGB dark(1, 1, 1);
+	const bool darkOk = table.getColorIndex(dark) == ev3::BLACK_COLOR;
+	printf("%-20s %5d: %s\n", "(1, 1, 1)", table.getColorIndex(dark), darkOk ? "ok" : "FAILED");
+
+	return centersOk && zeroOk && darkOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,168 @@
+/*
+ * CraneTimeCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Сравнение времени движения крана с исходной программой на модели мотора первого порядка,
+ * выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include -Isrc -Itest test/CraneTimeCheck.cpp src/Crane.cpp src/ProfiledMoveProcess.cpp -o crane_time && ./crane_time
+ *
+ * Исходная программа двигала кран MoveToEncoderAndStopProcess на мощности 100 с ограничением 7 секунд.
+ * Для каждой модели мотора (по умолчанию библиотеки и быстрее) выполняются движения миссии:
+ * вверх, вниз и на высоту проезда, каждое из одного и того же положения. Кран должен доходить до цели
+ * (ошибка не больше 10 градусов) не дольше исходной программы. Если исходная программа цели не достигла
+ * (при медленном моторе подъём прерывается по времени, после остановки мотор проезжает дальше),
+ * проверяется только, что кран до цели доходит.
+ */
+
+#include "LibraryStubs.h"
+
+#include <MotorDynamics.h>
+
+#include "Crane.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ev3;
+
+/**
+ * Мотор с моделью первого порядка (см. MotorDynamics::getFeedforwardPower)
+ */
+struct SimulatedMotor : TestMotor {
+	SimulatedMotor(Port port, float speedOnMaxPower, int startUpPower, float timeConstant)
+	: TestMotor(port), speedOnMaxPower(speedOnMaxPower), startUpPower(startUpPower), timeConstant(timeConstant) {
+	}
+
+	void step(float dt) {
+		const int power = getPower();
+		float steadyVelocity = 0;
+		if (std::abs(power) > startUpPower) {
+			steadyVelocity = speedOnMaxPower * (power > 0 ? power - startUpPower : power + startUpPower) / 100;
+		}
+		velocity += (steadyVelocity - velocity) * dt / timeConstant;
+		position += velocity * dt;
+		encoder = (int)std::lround(position);
+		actualSpeed = (int8_t)std::lround(velocity * 100 / speedOnMaxPower);
+	}
+
+	/**
+	 * Поставить мотор неподвижно в положение position
+	 */
+	void place(int position) {
+		this->position = (float)position;
+		velocity = 0;
+		encoder = position;
+		actualSpeed = 0;
+	}
+
+	void configure() {
+		setSpeedOnMaxPower(speedOnMaxPower);
+		setStartUpPower(startUpPower);
+		setMaxAccelleration(500000.0f);
+	}
+
+	float speedOnMaxPower;
+	int startUpPower;
+	float timeConstant;
+	float velocity = 0;
+	float position = 0;
+};
+
+// настройки мотора в заглушке: Motor::set* реализованы в библиотеке
+void Motor::setSpeedOnMaxPower(float degreesPerSecond) {
+	powerToSpeedRatio = degreesPerSecond / 100;
+}
+
+void Motor::setStartUpPower(int startUpPower) {
+	this->startUpPower = startUpPower;
+}
+
+void Motor::setMaxAccelleration(float maxAcceleration) {
+	this->maxAcceleration = maxAcceleration;
+}
+
+const ev3::time_t DT = 0.01f;
+const ev3::time_t MAX_TIME = 20.0f;
+
+static ticks_t now = 0;
+
+/**
+ * Цикл EV3::runProcess с моделью мотора
+ * @return время выполнения процесса в секундах
+ */
+static ev3::time_t run(const std::shared_ptr<Process> &process, SimulatedMotor &motor) {
+	const ticks_t start = now;
+	ev3::time_t timestamp = 0;
+	while (!process->isCompleted(timestamp) && (now - start) < MAX_TIME * TICKS_PER_SECOND) {
+		now += (ticks_t)(DT * TICKS_PER_SECOND);
+		Clock::beginTick(now);
+		timestamp = Clock::tickSeconds();
+		process->update(timestamp);
+		motor.step(DT);
+	}
+	process->onCompleted(timestamp);
+	return (now - start) / (ev3::time_t)TICKS_PER_SECOND;
+}
+
+/**
+ * Движение крана в исходной программе
+ */
+static std::shared_ptr<Process> baselineMoveTo(const MotorPtr &motor, int encoder) {
+	auto moveProcess = std::make_shared<MoveToEncoderAndStopProcess>(motor, encoder, 100, std::make_shared<PID>(1.0f, 0.00001f, 2.0f));
+	moveProcess->setEncoderThreshold(10);
+	moveProcess->setPowerThreshold(5);
+	return (moveProcess & std::make_shared<WaitTimeProcess>(7.0f)) >> StopProcess(motor);
+}
+
+struct Model {
+	const char *name;
+	float speedOnMaxPower;
+	int startUpPower;
+	float timeConstant;
+	Motor::Port basePort;
+	Motor::Port cranePort;
+};
+
+int main() {
+	Clock::enterLoop();
+	bool ok = true;
+
+	const Model models[] = {
+		{ "default", 850.0f, 3, 0.1f, Motor::Port::A, Motor::Port::B },
+		{ "fast", 1400.0f, 5, 0.06f, Motor::Port::C, Motor::Port::D },
+	};
+	const int starts[] = { 0, -6400, 0 };
+	const int targets[] = { -6400, 0, -1300 };
+	const char *names[] = { "up", "down", "free to move" };
+
+	for (const Model &model : models) {
+		SimulatedMotor base(model.basePort, model.speedOnMaxPower, model.startUpPower, model.timeConstant);
+		auto craneMotor = std::make_shared<SimulatedMotor>(model.cranePort, model.speedOnMaxPower, model.startUpPower, model.timeConstant);
+		craneMotor->configure();
+		MotorDynamics::of(craneMotor)->setTimeConstant(model.timeConstant);
+		MotorPtr baseMotor(MotorPtr(), &base);
+		Crane crane(craneMotor);
+
+		for (int i = 0; i < 3; ++i) {
+			base.place(starts[i]);
+			craneMotor->place(starts[i]);
+			const ev3::time_t baseTime = run(baselineMoveTo(baseMotor, targets[i]), base);
+			const int baseError = base.getEncoder() - targets[i];
+			const bool baseReached = std::abs(baseError) <= 10;
+			const ev3::time_t estimate = i == 0 ? crane.estimateUp() : (i == 1 ? crane.estimateDown() : crane.estimateFreeToMove());
+			const ev3::time_t craneTime = run(i == 0 ? crane.up() : (i == 1 ? crane.down() : crane.freeToMove()), *craneMotor);
+			const int craneError = craneMotor->getEncoder() - targets[i];
+			const bool craneReached = std::abs(craneError) <= 10;
+			const bool moveOk = craneReached && (!baseReached || craneTime <= baseTime);
+			printf("%-8s %-13s baseline %5.2f s, error %4d; crane %5.2f s, error %4d, estimate %5.2f s: %s\n", model.name, names[i],
+					baseTime, baseError, craneTime, craneError, estimate, moveOk ? "ok" : "FAILED");
+			ok = moveOk && ok;
+		}
+	}
+
+	Clock::leaveLoop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,67 @@
+/*
+ * CrossDetectorReplay.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Проверка CrossDetector на записанных показаниях, выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include -Isrc test/CrossDetectorReplay.cpp -o cross_replay && ./cross_replay test/traces
+ *
+ * Формат записей тот же, что у debugRecordCrossTraces. cross50, cross70 и cross100 - проезд перекрёстка
+ * на мощностях 50, 70 и 100, перекрёсток начинается через 600 градусов левого энкодера от начала записи.
+ * oscillation100 - тот же перекрёсток на мощности 100 с сильными колебаниями на линии: датчики заходят
+ * на линию по очереди, и перекрёсток не должен находиться раньше времени.
+ *
+ * Ограничение: файлы в test/traces не записаны на роботе, а построены моделью движения по линии
+ * (разброс длительности такта, шум датчиков, колебания поперёк линии). Проверка подтверждает поведение
+ * детектора на этой модели, но не на реальном поле. Записи с робота (debugRecordCrossTraces, файлы crossN.txt) нужно
+ * положить на место модельных и проверить тем же запуском.
+ */
+
+#include "CrossTrace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// перекрёсток начинается на этом расстоянии, срабатывание - после заполнения окна чёрным
+const int CROSS_START = 600;
+const int CROSS_WINDOW_END = CROSS_START + ev3::CrossDetector<>::windowWidth;
+// допустимое отклонение места срабатывания: шаг такта на мощности 100 и перекос датчиков
+const int TOLERANCE = 12;
+// места срабатывания на разных мощностях не должны отличаться больше, чем на это расстояние:
+// такт на мощности 100 - около 4 градусов, ещё до 5 градусов - разница колёс при колебаниях на линии
+const int MAX_SPREAD = 10;
+const int MEAN_THRESHOLD = 10;
+
+static bool checkTrace(const std::string &directory, const char *name, int &distance) {
+	const std::string filename = directory + "/" + name;
+	distance = replayCrossTrace(filename.c_str(), MEAN_THRESHOLD);
+	const bool ok = distance >= CROSS_WINDOW_END - TOLERANCE && distance <= CROSS_WINDOW_END + TOLERANCE;
+	printf("%-20s cross at %4d: %s\n", name, distance, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main(int argc, char **argv) {
+	const std::string directory = argc > 1 ? argv[1] : "test/traces";
+	bool ok = true;
+
+	int minDistance = 0;
+	int maxDistance = 0;
+	bool first = true;
+	for (const char *name : { "cross50.txt", "cross70.txt", "cross100.txt" }) {
+		int distance;
+		ok = checkTrace(directory, name, distance) && ok;
+		minDistance = first || distance < minDistance ? distance : minDistance;
+		maxDistance = first || distance > maxDistance ? distance : maxDistance;
+		first = false;
+	}
+	const bool sameDistance = maxDistance - minDistance <= MAX_SPREAD;
+	printf("%-20s %4d: %s\n", "spread", maxDistance - minDistance, sameDistance ? "ok" : "FAILED");
+	ok = sameDistance && ok;
+
+	int distance;
+	ok = checkTrace(directory, "oscillation100.txt", distance) && ok;
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
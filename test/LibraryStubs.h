@@ -0,0 +1,413 @@
+/*
+ * LibraryStubs.h
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Упрощённые реализации классов библиотеки для проверок на компьютере. Библиотека собрана для блока EV3,
+ * поэтому проверки процессов и моторов подключают этот файл в одну единицу трансляции вместо неё.
+ * Поведение повторяет описание в заголовках библиотеки:
+ * - Process::update при первом вызове вызывает onStarted;
+ * - группа обновляет незавершённые процессы и вызывает onCompleted у завершившихся, у прерванных - нет;
+ * - последовательность выполняет процессы по очереди и вызывает onCompleted у каждого завершившегося;
+ * - мотор хранит провод мощности, каждый setPower устанавливает новый провод.
+ *
+ * Процессы движения, датчики и EV3 реализованы только настолько, чтобы строить деревья процессов
+ * (см. AllocationCheck): процессы движения ничего не делают и не завершаются, датчики возвращают 0.
+ * PID, StopProcess и MoveToEncoderAndStopProcess работают, чтобы сравнивать с ними движения по модели
+ * мотора (см. CraneTimeCheck).
+ */
+
+#pragma once
+
+#include <EV3.h>
+#include <Motor.h>
+#include <Sensor.h>
+#include <PID.h>
+#include <Process.h>
+#include <processes.h>
+#include <core/ev3_output.h>
+
+#include <cstdlib>
+
+namespace ev3 {
+
+void Process::update(time_t secondsFromStart) {
+	if (!isStarted) {
+		isStarted = true;
+		onStarted(secondsFromStart);
+	}
+}
+
+void Process::onStarted(time_t) {
+}
+
+void Process::onCompleted(time_t) {
+}
+
+bool Process::isCompleted(time_t) {
+	return false;
+}
+
+ProcessGroup::ProcessGroup(bool completeIfAnyIsCompleted)
+: completeIfAnyIsCompleted(completeIfAnyIsCompleted) {
+}
+
+void ProcessGroup::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	for (const std::shared_ptr<Process> &process : group) {
+		if (!process->isCompleted(secondsFromStart)) {
+			process->update(secondsFromStart);
+			if (process->isCompleted(secondsFromStart)) {
+				process->onCompleted(secondsFromStart);
+			}
+		}
+	}
+}
+
+bool ProcessGroup::isCompleted(time_t secondsFromStart) {
+	for (const std::shared_ptr<Process> &process : group) {
+		if (process->isCompleted(secondsFromStart) == completeIfAnyIsCompleted) {
+			return completeIfAnyIsCompleted;
+		}
+	}
+	return !completeIfAnyIsCompleted;
+}
+
+ProcessGroupOr::ProcessGroupOr()
+: ProcessGroup(false) {
+}
+
+ProcessGroupAnd::ProcessGroupAnd()
+: ProcessGroup(true) {
+}
+
+ProcessSequence::ProcessSequence() {
+}
+
+void ProcessSequence::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	if (sequence.empty()) {
+		return;
+	}
+	const std::shared_ptr<Process> process = sequence.front();
+	process->update(secondsFromStart);
+	if (process->isCompleted(secondsFromStart)) {
+		process->onCompleted(secondsFromStart);
+		sequence.pop();
+	}
+}
+
+bool ProcessSequence::isCompleted(time_t) {
+	return sequence.empty();
+}
+
+Motor::Motor(Port port)
+: port(port), speedInput(0), encoderInput(0), tachoInput(0) {
+}
+
+Motor::~Motor() {
+}
+
+void Motor::setPower(int power) {
+	setPower(WireI(power));
+}
+
+void Motor::setPower(const WireI &output) {
+	powerOutput = std::make_shared<WireI>(output);
+}
+
+int Motor::getPower() const {
+	return powerOutput ? powerOutput->getValue() : 0;
+}
+
+void Motor::updateInputs(time_t) {
+}
+
+void Motor::updateOutputs(time_t) {
+}
+
+int Motor::getEncoder() const {
+	return encoder;
+}
+
+int Motor::getActualSpeed() const {
+	return actualSpeed;
+}
+
+void Motor::resetEncoder() {
+	encoder = 0;
+}
+
+void Motor::blockOnEncoder(int) {
+}
+
+bool Motor::isBusy() {
+	return false;
+}
+
+/**
+ * Мотор для проверок: конструктор мотора библиотеки доступен только EV3
+ */
+struct TestMotor : Motor {
+	explicit TestMotor(Port port)
+	: Motor(port) {
+	}
+};
+
+Sensor::Sensor(Port port)
+: port(port), mode(Mode::NO_SENSOR), value(0), valueInput(0) {
+}
+
+Sensor::~Sensor() {
+}
+
+int Sensor::getValue() const {
+	return value;
+}
+
+void Sensor::updateInputs(time_t) {
+}
+
+void Sensor::updateOutputs(time_t) {
+}
+
+/**
+ * Датчик для проверок: конструктор датчика библиотеки доступен только EV3
+ */
+struct TestSensor : Sensor {
+	explicit TestSensor(Port port, Mode mode = Mode::NO_SENSOR)
+	: Sensor(port) {
+		this->mode = mode;
+	}
+};
+
+PID::PID(float kp, float ki, float kd)
+: kp(kp), ki(ki), kd(kd), lastError(0), lastIntegralPart(0), lastUpdateTime(0), power(0), errorWire(0.0f) {
+}
+
+void PID::setError(const WireF &errorWire) {
+	this->errorWire = errorWire;
+}
+
+float PID::getPower() const {
+	return power;
+}
+
+void PID::update(time_t) {
+	// дискретный регулятор: интеграл и производная - по тактам
+	const float error = errorWire.getValue();
+	lastIntegralPart += error;
+	power = kp * error + ki * lastIntegralPart + kd * (error - lastError);
+	lastError = error;
+}
+
+void PID::reset() {
+	lastError = 0;
+	lastIntegralPart = 0;
+	power = 0;
+}
+
+void PID::setPID(float kP, float kI, float kD) {
+	kp = kP;
+	ki = kI;
+	kd = kD;
+}
+
+std::shared_ptr<FakeSensor> EV3::getFakeSensor(const WireI &) {
+	return nullptr;
+}
+
+std::shared_ptr<FakeSensor> EV3::getFakeSensor(int) {
+	return nullptr;
+}
+
+void EV3::playSound(unsigned short, time_t, float) {
+}
+
+LambdaProcess::LambdaProcess(const std::function<bool(time_t)> &updateFunc)
+: updateFunc(updateFunc), completed(false) {
+}
+
+void LambdaProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	completed = !updateFunc(secondsFromStart);
+}
+
+void LambdaProcess::onCompleted(time_t) {
+}
+
+bool LambdaProcess::isCompleted(time_t) {
+	return completed;
+}
+
+TimeProcess::TimeProcess(const std::function<void(time_t)> &updateFunc, time_t duration, time_t delay)
+: updateFunc(updateFunc), completed(false), startTime(0), duration(duration), delay(delay) {
+}
+
+void TimeProcess::onStarted(time_t secondsFromStart) {
+	startTime = secondsFromStart;
+}
+
+void TimeProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	completed = secondsFromStart - startTime >= delay + duration;
+}
+
+void TimeProcess::onCompleted(time_t) {
+}
+
+bool TimeProcess::isCompleted(time_t) {
+	return completed;
+}
+
+WaitTimeProcess::WaitTimeProcess(float secondsToWait)
+: TimeProcess([](time_t) {}, secondsToWait) {
+}
+
+MoveByEncoderOnArcProcess::MoveByEncoderOnArcProcess(MotorPtr leftMotor, MotorPtr rightMotor, int leftEncoderDistance, int rightEncoderDistance, int maxPower, std::shared_ptr<PID> pid)
+: leftMotor(leftMotor), rightMotor(rightMotor), leftEncoderDistance(leftEncoderDistance), rightEncoderDistance(rightEncoderDistance)
+, maxPower(maxPower), scaleLeft(1), scaleRight(1), dirLeft(1), dirRight(1), pd(pid ? pid : std::make_shared<PID>()) {
+}
+
+void MoveByEncoderOnArcProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+}
+
+void MoveByEncoderOnArcProcess::onStarted(time_t) {
+}
+
+void MoveByEncoderOnArcProcess::onCompleted(time_t) {
+}
+
+bool MoveByEncoderOnArcProcess::isCompleted(time_t) {
+	return false;
+}
+
+void MoveByEncoderOnArcProcess::setMaxPower(int maxPower) {
+	this->maxPower = maxPower;
+}
+
+StopByEncoderOnArcProcess::StopByEncoderOnArcProcess(MotorPtr leftMotor_, MotorPtr rightMotor_, int leftEncoderDistance_, int rightEncoderDistance_, int maxPower_,
+		std::shared_ptr<PID> movePID_, std::shared_ptr<PID> powerPID_)
+: leftMotor(leftMotor_), rightMotor(rightMotor_), leftEncoderDistance(leftEncoderDistance_), rightEncoderDistance(rightEncoderDistance_)
+, maxPower(maxPower_), minPower(0), dirLeft(1), dirRight(1), anchorEncoder(0), powerThreshold(0), speedThreshold(0)
+, powerPD(powerPID_ ? powerPID_ : std::make_shared<PID>())
+, moveByEncoderOnArcProcess(std::make_shared<MoveByEncoderOnArcProcess>(leftMotor_, rightMotor_, leftEncoderDistance_, rightEncoderDistance_, maxPower_, movePID_)) {
+}
+
+void StopByEncoderOnArcProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+}
+
+void StopByEncoderOnArcProcess::onStarted(time_t) {
+}
+
+void StopByEncoderOnArcProcess::onCompleted(time_t) {
+}
+
+bool StopByEncoderOnArcProcess::isCompleted(time_t) {
+	return false;
+}
+
+MoveOnLineProcess::MoveOnLineProcess(MotorPtr leftMotor, MotorPtr rightMotor, SensorPtr leftLight, SensorPtr rightLight, int encoderDistance, int maxPower, std::shared_ptr<PID> pid)
+: leftMotor(leftMotor), rightMotor(rightMotor), leftLight(leftLight), rightLight(rightLight)
+, encoderDistance(encoderDistance), maxPower(maxPower), pd(pid ? pid : std::make_shared<PID>()) {
+}
+
+void MoveOnLineProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+}
+
+void MoveOnLineProcess::onStarted(time_t) {
+}
+
+void MoveOnLineProcess::onCompleted(time_t) {
+}
+
+bool MoveOnLineProcess::isCompleted(time_t) {
+	return false;
+}
+
+void MoveOnLineProcess::setMaxPower(int maxPower) {
+	this->maxPower = maxPower;
+}
+
+StopOnLineProcess::StopOnLineProcess(MotorPtr leftMotor, MotorPtr rightMotor, SensorPtr leftLight, SensorPtr rightLight,
+		int encoderDistance, int maxPower, std::shared_ptr<PID> movePID, std::shared_ptr<PID> powerPID)
+: leftMotor(leftMotor), rightMotor(rightMotor), leftLight(leftLight), rightLight(rightLight), encoderDistance(encoderDistance)
+, maxPower(maxPower), minPower(0), anchorEncoder(0), powerThreshold(0), speedThreshold(0), distanceThreshold(0), encoderStart(0)
+, powerPD(powerPID ? powerPID : std::make_shared<PID>())
+, moveOnLineProcess(std::make_shared<MoveOnLineProcess>(leftMotor, rightMotor, leftLight, rightLight, encoderDistance, maxPower, movePID)) {
+}
+
+void StopOnLineProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+}
+
+void StopOnLineProcess::onStarted(time_t) {
+}
+
+void StopOnLineProcess::onCompleted(time_t) {
+}
+
+bool StopOnLineProcess::isCompleted(time_t) {
+	return false;
+}
+
+StopProcess::StopProcess(const MotorPtr &motor)
+: motor(motor), speedThreshold(3) {
+}
+
+void StopProcess::onStarted(time_t) {
+	motor->setPower(0);
+}
+
+bool StopProcess::isCompleted(time_t) {
+	return std::abs(motor->getActualSpeed()) <= speedThreshold;
+}
+
+WaitLineProcess::WaitLineProcess(const SensorPtr &lightSensor)
+: lightSensor(lightSensor), threshold(50) {
+}
+
+bool WaitLineProcess::isCompleted(time_t) {
+	return false;
+}
+
+MoveToEncoderAndStopProcess::MoveToEncoderAndStopProcess(MotorPtr motor, int targetEncoder, int power, std::shared_ptr<PID> pid)
+: motor(motor), targetEncoder(targetEncoder), power(power), pid(pid ? pid : std::make_shared<PID>()), powerThreshold(0), encoderThreshold(0) {
+}
+
+void MoveToEncoderAndStopProcess::update(time_t secondsFromStart) {
+	Process::update(secondsFromStart);
+	pid->update(secondsFromStart);
+	const int output = (int)pid->getPower();
+	motor->setPower(isCompleted(secondsFromStart) ? 0 : (output > power ? power : (output < -power ? -power : output)));
+}
+
+void MoveToEncoderAndStopProcess::onStarted(time_t) {
+	pid->setError(WireF([this] { return (float)(targetEncoder - motor->getEncoder()); }));
+}
+
+bool MoveToEncoderAndStopProcess::isCompleted(time_t) {
+	return std::abs(targetEncoder - motor->getEncoder()) <= encoderThreshold && std::abs(pid->getPower()) <= powerThreshold;
+}
+
+void MoveToEncoderAndStopProcess::setPowerThreshold(int threshold) {
+	powerThreshold = threshold;
+}
+
+void MoveToEncoderAndStopProcess::setEncoderThreshold(int threshold) {
+	encoderThreshold = threshold;
+}
+
+} /* namespace ev3 */
+
+bool OutputStop(uint8_t, bool) {
+	return true;
+}
+
+bool OutputStepSyncEx(uint8_t, int8_t, short, int, bool, uint8_t) {
+	return true;
+}
@@ -0,0 +1,129 @@
+/*
+ * MotorArbiterCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Проверка MotorArbiter и MotorClaimProcess, выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include -Itest test/MotorArbiterCheck.cpp -o motor_arbiter && ./motor_arbiter
+ *
+ * - вложенный процесс с тем же приоритетом управляет мотором, пока выполняется, и после него
+ *   не возвращается старая команда внешнего процесса (как в Move: движение >> остановка);
+ * - процесс, прерванный группой &, не удерживает мотор ни пока дерево существует, ни после.
+ *
+ * Арбитр один на порт (см. MotorArbiter::of), поэтому каждая проверка использует свой порт.
+ */
+
+#include "LibraryStubs.h"
+
+#include <MotorArbiter.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace ev3;
+
+/**
+ * Процесс, который на каждом такте записывает в мотор одну и ту же мощность
+ */
+class Writer : public virtual Process {
+public:
+	Writer(MotorPtr motor, int power, int ticks)
+	: motor(std::move(motor)), power(power), ticks(ticks), numberOfTicks(0) {
+	}
+
+	virtual void update(ev3::time_t secondsFromStart) override {
+		Process::update(secondsFromStart);
+		motor->setPower(power);
+		numberOfTicks++;
+	}
+
+	virtual bool isCompleted(ev3::time_t) override {
+		return ticks > 0 && numberOfTicks >= ticks;
+	}
+
+private:
+	MotorPtr motor;
+	int power;
+	int ticks;
+	int numberOfTicks;
+};
+
+static ticks_t now = 0;
+
+/**
+ * Цикл EV3::runProcess: мощность мотора читается после обновления процесса, как в updateOutputs
+ * @return мощность мотора на каждом такте
+ */
+static std::vector<int> run(const std::shared_ptr<Process> &process, const MotorPtr &motor, int maxTicks = 100) {
+	std::vector<int> powers;
+	ev3::time_t timestamp = 0;
+	while (!process->isCompleted(timestamp) && (int)powers.size() < maxTicks) {
+		now += 10 * TICKS_PER_MILLISECOND;
+		Clock::beginTick(now);
+		timestamp = Clock::tickSeconds();
+		process->update(timestamp);
+		powers.push_back(motor->getPower());
+	}
+	process->onCompleted(timestamp);
+	return powers;
+}
+
+static bool check(const char *name, const std::vector<int> &powers, const std::vector<int> &expected) {
+	const bool ok = powers == expected;
+	printf("%-28s", name);
+	for (int power : powers) {
+		printf(" %d", power);
+	}
+	printf(": %s\n", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main() {
+	Clock::enterLoop();
+	bool ok = true;
+
+	// вложенный захват с тем же приоритетом
+	{
+		MotorPtr motor = std::make_shared<TestMotor>(Motor::Port::A);
+		auto inner = claimMotors(std::make_shared<Writer>(motor, 0, 5), { motor });
+		auto outer = claimMotors(std::make_shared<Writer>(motor, 70, 3) >> inner, { motor });
+		ok = check("nested claim", run(outer, motor), { 70, 70, 70, 0, 0, 0, 0, 0 }) && ok;
+	}
+
+	// после вложенного захвата мотор сохраняет его мощность, а не старую команду внешнего
+	{
+		MotorPtr motor = std::make_shared<TestMotor>(Motor::Port::D);
+		auto inner = claimMotors(std::make_shared<Writer>(motor, 0, 2), { motor });
+		auto outer = claimMotors(std::make_shared<Writer>(motor, 70, 2) >> inner >> std::make_shared<Writer>(motor, 40, 2), { motor });
+		ok = check("after nested claim", run(outer, motor), { 70, 70, 0, 0, 40, 40 }) && ok;
+	}
+
+	// захват, прерванный группой &, пока дерево процессов существует
+	{
+		MotorPtr motor = std::make_shared<TestMotor>(Motor::Port::B);
+		auto cut = claimMotors(std::make_shared<Writer>(motor, 50, 0), { motor }, 1);
+		auto group = cut & std::make_shared<Writer>(motor, 50, 2);
+		ok = check("cut short claim", run(group, motor), { 50, 50 }) && ok;
+		// брошенный токен с большим приоритетом не участвует в выборе владельца
+		auto next = claimMotors(std::make_shared<Writer>(motor, 20, 3), { motor });
+		ok = check("claim after cut short", run(next, motor), { 20, 20, 20 }) && ok;
+	}
+
+	// прерванный захват освобождается вместе с деревом процессов
+	{
+		MotorPtr motor = std::make_shared<TestMotor>(Motor::Port::C);
+		std::shared_ptr<MotorArbiter> arbiter = MotorArbiter::of(motor);
+		{
+			auto group = claimMotors(std::make_shared<Writer>(motor, 50, 0), { motor }, 1) & std::make_shared<Writer>(motor, 50, 1);
+			run(group, motor);
+		}
+		const bool released = arbiter->getOwner() == MotorArbiter::NO_TOKEN;
+		printf("%-28s: %s\n", "released with tree", released ? "ok" : "FAILED");
+		ok = released && ok;
+	}
+
+	Clock::leaveLoop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
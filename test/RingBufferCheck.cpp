@@ -0,0 +1,96 @@
+/*
+ * RingBufferCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Проверка RingBuffer и SpscRing, выполняется на компьютере:
+ *   g++ -std=c++17 -pthread -IAPI/include test/RingBufferCheck.cpp -o ring_buffer && ./ring_buffer
+ *
+ * - в однопоточном режиме при переполнении вытесняется самое старое значение, порядок обхода сохраняется;
+ * - tryPush и tryPop соблюдают ёмкость;
+ * - два потока передают через SpscRing последовательность значений без потерь и перестановок,
+ *   а lastValue в читающем потоке никогда не возвращает ещё не записанное значение.
+ */
+
+#include <Ring.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static bool check(const char *name, bool ok) {
+	printf("%-28s: %s\n", name, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main() {
+	bool ok = true;
+
+	// однопоточный режим: вытеснение самого старого значения
+	{
+		ev3::RingBuffer<int, 4> ring;
+		for (int i = 1; i <= 6; ++i) {
+			ring.push(i);
+		}
+		std::vector<int> values;
+		ring.iterate([&values](int value) { values.push_back(value); });
+		ok = check("overwrite oldest", ring.size() == 4 && values == std::vector<int>({ 3, 4, 5, 6 })) && ok;
+		ok = check("first and last", ring.firstValue() == 3 && ring.lastValue() == 6) && ok;
+		ring.clear();
+		ok = check("clear", ring.empty()) && ok;
+	}
+
+	// ёмкость в режиме tryPush / tryPop
+	{
+		ev3::SpscRing<int, 4> ring;
+		int pushed = 0;
+		while (ring.tryPush(pushed)) {
+			pushed++;
+		}
+		int value = -1;
+		bool popped = ring.tryPop(value);
+		ok = check("try push capacity", pushed == 4 && popped && value == 0 && ring.tryPush(4) && !ring.tryPush(5)) && ok;
+		int count = 0;
+		while (ring.tryPop(value)) {
+			count++;
+		}
+		ok = check("try pop empty", count == 4 && value == 4 && ring.empty()) && ok;
+	}
+
+	// два потока
+	{
+		const int numberOfValues = 100000;
+		static ev3::SpscRing<int, 64> ring;
+		std::atomic<bool> writing { true };
+		std::thread writer([] {
+			for (int i = 0; i < numberOfValues;) {
+				if (ring.tryPush(i)) {
+					i++;
+				}
+			}
+		});
+		int expected = 0;
+		bool ordered = true;
+		bool lastWritten = true;
+		while (expected < numberOfValues) {
+			if (!ring.empty()) {
+				// последнее значение записано не раньше, чем уже прочитанные
+				lastWritten = lastWritten && ring.lastValue() >= expected;
+			}
+			int value;
+			if (ring.tryPop(value)) {
+				ordered = ordered && value == expected;
+				expected++;
+			}
+		}
+		writer.join();
+		writing = false;
+		ok = check("spsc order", ordered && ring.empty()) && ok;
+		ok = check("spsc last value", lastWritten) && ok;
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
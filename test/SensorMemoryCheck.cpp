@@ -0,0 +1,127 @@
+/*
+ * SensorMemoryCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Проверка SensorMemory на областях памяти FakeSensorMemory, выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include -Itest test/SensorMemoryCheck.cpp -o sensor_memory && ./sensor_memory
+ *
+ * - update отмечает только порты, на которых драйвер записал новое значение, в том числе после переноса
+ *   индекса журнала;
+ * - значения декодируются по режиму датчика, компоненты RGB сохраняются без потерь (0..1023);
+ * - getValueWire проверяет счётчики один раз за такт;
+ * - после attach SensorSamples::isNewSample следует счётчику драйвера, а не тактам;
+ * - у каждого датчика FakeSensor (все на порту FAKE) свой объект SensorSamples.
+ */
+
+#include "LibraryStubs.h"
+
+#include <SensorMemory.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace ev3;
+
+static bool check(const char *name, long value, long expected) {
+	const bool ok = value == expected;
+	printf("%-28s %8ld: %s\n", name, value, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static ticks_t now = 0;
+
+static void nextTick() {
+	now += 10 * TICKS_PER_MILLISECOND;
+	Clock::beginTick(now);
+}
+
+int main() {
+	Clock::enterLoop();
+	bool ok = true;
+
+	FakeSensorMemory fake;
+	std::unique_ptr<SensorMemory> memory = fake.createSensorMemory();
+
+	// порт 1 - датчик цвета (UART) в режиме отражённого света, порт 2 - в режиме RGB
+	fake.setConnection(0, CONN_INPUT_UART);
+	fake.setConnection(1, CONN_INPUT_UART);
+	memory->setMode(0, Sensor::Mode::COLOR_REFLECT);
+	memory->setMode(1, Sensor::Mode::COLOR_RGB);
+
+	const uint8_t reflect = 42;
+	fake.setUart(0, &reflect, sizeof(reflect));
+	const int16_t rgb[3] = { 1023, 300, 7 };
+	fake.setUart(1, rgb, sizeof(rgb));
+
+	nextTick();
+	ok = check("first update mask", memory->update(), 0x3) && ok;
+	ok = check("reflect value", memory->getValue(0), 42) && ok;
+	const int packed = memory->getValue(1);
+	ok = check("rgb r", SensorMemory::getRGBComponent(packed, 0), 1023) && ok;
+	ok = check("rgb g", SensorMemory::getRGBComponent(packed, 1), 300) && ok;
+	ok = check("rgb b", SensorMemory::getRGBComponent(packed, 2), 7) && ok;
+
+	// без новых данных значение и маска не меняются
+	nextTick();
+	ok = check("no new data mask", memory->update(), 0) && ok;
+
+	// журнал драйвера переполняется: каждая запись видна как новое значение
+	int updates = 0;
+	for (int i = 0; i < 3 * DEVICE_LOGBUF_SIZE; ++i) {
+		const uint8_t value = (uint8_t)i;
+		fake.setUart(0, &value, sizeof(value));
+		nextTick();
+		updates += memory->update() & 1;
+	}
+	ok = check("updates after wrap", updates, 3 * DEVICE_LOGBUF_SIZE) && ok;
+	ok = check("value after wrap", memory->getValue(0), (uint8_t)(3 * DEVICE_LOGBUF_SIZE - 1)) && ok;
+
+	// аналоговый датчик касания
+	fake.setConnection(2, CONN_INPUT_DUMB);
+	memory->setMode(2, Sensor::Mode::TOUCH);
+	fake.setAnalog(2, 4000);
+	nextTick();
+	memory->update();
+	ok = check("touch pressed", memory->getValue(2), 1) && ok;
+
+	// провод значения: одна проверка счётчиков за такт
+	WireI wire = memory->getValueWire(0);
+	const uint8_t first = 10;
+	fake.setUart(0, &first, sizeof(first));
+	nextTick();
+	ok = check("wire value", wire.getValue(), 10) && ok;
+	const uint8_t second = 20;
+	fake.setUart(0, &second, sizeof(second));
+	ok = check("wire same tick", wire.getValue(), 10) && ok;
+	nextTick();
+	ok = check("wire next tick", wire.getValue(), 20) && ok;
+
+	// счётчик драйвера в SensorSamples: новое значение только после записи драйвера
+	SensorPtr light = std::make_shared<TestSensor>(Sensor::Port::P4, Sensor::Mode::COLOR_REFLECT);
+	fake.setConnection(3, CONN_INPUT_UART);
+	memory->attach(light);
+	std::shared_ptr<SensorSamples> samples = SensorSamples::of(light);
+	int newSamples = 0;
+	for (int i = 0; i < 12; ++i) {
+		if (i % 3 == 0) {
+			const uint8_t value = (uint8_t)i;
+			fake.setUart(3, &value, sizeof(value));
+		}
+		nextTick();
+		newSamples += samples->isNewSample() ? 1 : 0;
+	}
+	ok = check("new samples in 12 ticks", newSamples, 4) && ok;
+
+	// датчики на порту FAKE различаются по самому датчику, а не по порту
+	SensorPtr firstFake = std::make_shared<TestSensor>(Sensor::Port::FAKE);
+	SensorPtr secondFake = std::make_shared<TestSensor>(Sensor::Port::FAKE);
+	std::shared_ptr<SensorSamples> firstSamples = SensorSamples::of(firstFake);
+	ok = check("fake samples distinct", SensorSamples::of(secondFake) != firstSamples, true) && ok;
+	ok = check("fake samples same sensor", SensorSamples::of(firstFake) == firstSamples, true) && ok;
+	ok = check("fake samples sensor", SensorSamples::of(secondFake)->getSensor() == secondFake, true) && ok;
+
+	Clock::leaveLoop();
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,94 @@
+/*
+ * StatisticsRingCheck.cpp
+ *
+ *  Created on: 19 окт. 2026 г.
+ *      Author: Pavel Skorynin
+ *
+ * Проверка StatisticsRing, выполняется на компьютере:
+ *   g++ -std=c++17 -IAPI/include test/StatisticsRingCheck.cpp -o statistics_ring && ./statistics_ring
+ *
+ * Сумма, среднее, дисперсия, минимум и максимум окна после каждого push сравниваются с прямым
+ * вычислением по последним N значениям: для случайных значений, для монотонных последовательностей
+ * (худший случай для монотонных очередей), для повторяющихся значений и после clear.
+ */
+
+#include <Ring.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+const int N = 16;
+
+/**
+ * Прогон последовательности через StatisticsRing и прямое вычисление статистики окна
+ * @return количество несовпадений
+ */
+static int compare(ev3::StatisticsRing<int, N> &ring, const std::vector<int> &values) {
+	std::deque<int> window;
+	int numberOfMismatches = 0;
+	for (int value : values) {
+		ring.push(value);
+		window.push_back(value);
+		if ((int)window.size() > N) {
+			window.pop_front();
+		}
+		long long sum = 0;
+		long long sumOfSquares = 0;
+		for (int v : window) {
+			sum += v;
+			sumOfSquares += (long long)v * v;
+		}
+		const float mean = (float)sum / window.size();
+		const float variance = std::max(0.0f, (float)sumOfSquares / window.size() - mean * mean);
+		const bool ok = ring.size() == (int)window.size()
+				&& ring.getSum() == sum
+				&& std::fabs(ring.getMean() - mean) < 1e-3f
+				&& std::fabs(ring.getVariance() - variance) <= 1e-3f * std::max(1.0f, variance)
+				&& ring.getMin() == *std::min_element(window.begin(), window.end())
+				&& ring.getMax() == *std::max_element(window.begin(), window.end());
+		if (!ok) {
+			numberOfMismatches++;
+		}
+	}
+	return numberOfMismatches;
+}
+
+static bool check(const char *name, int numberOfMismatches) {
+	const bool ok = numberOfMismatches == 0;
+	printf("%-20s %5d mismatches: %s\n", name, numberOfMismatches, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+int main() {
+	bool ok = true;
+
+	std::vector<int> random;
+	srand(1);
+	for (int i = 0; i < 10000; ++i) {
+		random.push_back(rand() % 2001 - 1000);
+	}
+	std::vector<int> increasing;
+	std::vector<int> decreasing;
+	std::vector<int> repeated;
+	for (int i = 0; i < 200; ++i) {
+		increasing.push_back(i);
+		decreasing.push_back(-i);
+		repeated.push_back((i / 7) % 3);
+	}
+
+	ev3::StatisticsRing<int, N> ring;
+	ok = check("random", compare(ring, random)) && ok;
+	ring.clear();
+	ok = check("empty after clear", ring.size() == 0 && ring.getSum() == 0 ? 0 : 1) && ok;
+	ok = check("increasing", compare(ring, increasing)) && ok;
+	ring.clear();
+	ok = check("decreasing", compare(ring, decreasing)) && ok;
+	ring.clear();
+	ok = check("repeated", compare(ring, repeated)) && ok;
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}